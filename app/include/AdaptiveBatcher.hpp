@@ -0,0 +1,47 @@
+#ifndef ADAPTIVE_BATCHER_HPP
+#define ADAPTIVE_BATCHER_HPP
+
+#include "AiRequestDispatcher.hpp"
+#include <QList>
+#include <QString>
+#include <deque>
+#include <functional>
+
+// Sizes AI analysis batches. A batch is bounded by the model's prompt
+// budget (estimated tokens of the file lines) and by how many answers fit
+// in the response. The file-count target shrinks when a response comes
+// back truncated or only partly parseable and grows again on clean ones.
+class AdaptiveBatcher {
+public:
+    void configure(const AiProviderConfig& config, int prompt_overhead_tokens);
+    // Any batch may land on any provider of a pool, so size for the tightest
+    void configure(const QList<AiProviderConfig>& pool, int prompt_overhead_tokens);
+
+    // Pop the next batch off the front of `pending`. `line_tokens` gives
+    // the estimated prompt cost of one file's line.
+    QList<int> take_batch(std::deque<int>& pending, const std::function<int(int)>& line_tokens) const;
+
+    // Feed back how a batch went
+    void record_result(int requested, int parsed, bool truncated);
+
+    int target_files() const { return target_files_; }
+    int max_files() const { return max_files_; }
+
+    // Heuristic: a JSON array reply that does not close was cut off
+    static bool looks_truncated(const QString& content);
+    // Prompt window for a model, in tokens
+    static int context_tokens(const AiProviderConfig& config);
+
+    static constexpr int kInitialBatchFiles = 50;
+    static constexpr int kMinBatchFiles = 5;
+    // Response budget per request and per classified file
+    static constexpr int kResponseTokens = 4096;
+    static constexpr int kTokensPerAnswer = 60;
+
+private:
+    int target_files_ = kInitialBatchFiles;
+    int max_files_ = kInitialBatchFiles;
+    int prompt_budget_ = 0;
+};
+
+#endif // ADAPTIVE_BATCHER_HPP
@@ -83,6 +83,8 @@ private:
     // Override actions
     void on_finish() override;
     void on_undo() override;
+    void assign_files_to_folder(const QList<int>& indices, const QString& dest) override;
+    void on_bulk_moves(const QHash<QString, int>& moves_per_folder) override;
 
 protected:
     // show_current_file accessible to AI mode for override chaining
@@ -2,6 +2,8 @@
 #define AI_FILE_TINDER_DIALOG_HPP
 
 #include "AdvancedFileTinderDialog.hpp"
+#include "AiRequestDispatcher.hpp"
+#include "AdaptiveBatcher.hpp"
 #include <QDialog>
 #include <QComboBox>
 #include <QSpinBox>
@@ -14,20 +16,16 @@
 #include <QNetworkReply>
 #include <QTimer>
 #include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QPointer>
+#include <QElapsedTimer>
 #include <QTextBrowser>
 
 class MindMapView;
 class FolderTreeModel;
-
-// Stores an AI provider configuration
-struct AiProviderConfig {
-    QString provider_name;
-    QString api_key;
-    QString endpoint_url;
-    QString model_name;
-    bool is_local = false;
-    int rate_limit_rpm = 60;
-};
+class QProgressBar;
+class QListWidget;
 
 // AI sorting mode
 enum class AiSortMode {
@@ -68,6 +66,8 @@ public:
     int category_depth() const;
     QString folder_purpose() const;
     AiProviderConfig provider_config() const;
+    // Selected provider first, then the checked fallbacks
+    QList<AiProviderConfig> provider_pool() const;
     int confidence_threshold() const;
 
 private:
@@ -77,6 +77,10 @@ private:
     void update_cost_estimate();
     void fetch_models(const QString& provider);
     int default_rate_limit(const QString& provider) const;
+    int default_token_limit(const QString& provider) const;
+    int default_concurrency(const QString& provider) const;
+    AiProviderConfig make_provider_config(const QString& provider, const QString& api_key,
+                                          const QString& endpoint, const QString& model) const;
 
     DatabaseManager& db_;
     QString session_folder_;
@@ -87,6 +91,7 @@ private:
     QLineEdit* api_key_edit_;
     QLineEdit* endpoint_edit_;
     QComboBox* model_combo_;
+    QListWidget* fallback_list_;
     QRadioButton* auto_radio_;
     QRadioButton* semi_radio_;
     QSpinBox* semi_count_spin_;
@@ -120,21 +125,49 @@ private:
     int semi_count_;
     int category_depth_;
     QString folder_purpose_;
-    AiProviderConfig provider_config_;
+    AiProviderConfig provider_config_;           // Primary provider
+    QList<AiProviderConfig> provider_pool_;      // Primary + fallbacks
     std::vector<AiFileSuggestion> suggestions_;
 
     QStringList highlighted_folders_;
     QPushButton* ai_setup_btn_ = nullptr;
     QPushButton* rerun_ai_btn_ = nullptr;
 
-    // Network
-    QNetworkAccessManager* network_manager_;
-    QTimer* rate_limit_timer_;
-    int requests_this_minute_;
+    // Network — all provider traffic goes through the dispatcher
+    AiRequestDispatcher* dispatcher_;
     bool ai_configured_ = false;
-    bool is_free_tier_ = false;
-    int consecutive_429s_ = 0;
-    qint64 last_request_ms_ = 0;
+
+    // State of the analysis run in progress
+    struct AnalysisBatch {
+        QList<int> file_indices;
+        bool is_retry = false;
+        QSet<int> received;                 // Files with an accepted suggestion
+        QHash<QString, QString> to_cache;   // fingerprint -> suggestion JSON
+        bool from_fallback = false;         // Some answers came from a non-primary provider
+    };
+    QHash<int, AnalysisBatch> active_batches_;  // dispatcher request id -> batch
+    std::deque<int> analysis_pending_;          // File indices not yet batched
+    QHash<int, int> pending_position_;          // file index -> filtered position at the last full sort
+    int prioritized_at_ = -1;                   // Position analysis_pending_ is ordered from (-1 = unsorted)
+    int prioritized_count_ = 0;                 // filtered_indices_ size at the last full sort
+    QString analysis_cache_key_;                // Classification cache scope for this run
+    QString analysis_preamble_;                 // Shared, cacheable prompt prefix
+    QHash<int, QString> content_hints_;         // file index -> content hint ("" = none found)
+    int analysis_preparing_ = 0;                // Batches waiting for their content hints
+    int analysis_generation_ = 0;
+    AdaptiveBatcher batcher_;
+    QStringList analysis_folders_;
+    int analysis_total_ = 0;
+    int analysis_done_ = 0;        // Files classified or given up on
+    int analysis_classified_ = 0;
+    bool analysis_stopped_ = false;
+    int consecutive_batch_failures_ = 0;
+    static constexpr int kMaxConsecutiveBatchFailures = 3;
+    QPointer<QTextBrowser> analysis_log_;
+    QPointer<QProgressBar> analysis_progress_;
+    bool analysis_running_ = false;
+    QPointer<QDialog> analysis_window_;
+    QElapsedTimer analysis_timer_;
 
     QWidget* ai_suggestions_panel_ = nullptr;
     QListWidget* ai_suggestions_list_ = nullptr;
@@ -152,18 +185,62 @@ private:
     // Show AI setup dialog; returns false if user cancelled
     bool show_ai_setup();
 
-    // Run the AI analysis on files (all or remaining only)
+    // Start AI analysis on files (all or remaining only). Returns at once;
+    // batches run in the background while the user keeps sorting
     void run_ai_analysis(bool remaining_only);
+    void complete_ai_analysis();
+    void update_analysis_progress();
+    // Order analysis_pending_ by when the user will reach each file. Forward
+    // swipes only rotate passed files to the back; a full sort happens on a
+    // jump back or a filter change.
+    void prioritize_pending();
+
+    // Batches are cut from analysis_pending_ as slots free up; results
+    // merge in as they arrive
+    void fill_analysis_queue();
+    // Extract content hints for a batch's files, then submit it
+    void prepare_analysis_batch(const QList<int>& file_indices);
+    void submit_analysis_batch(const QList<int>& file_indices, bool is_retry);
+    void on_analysis_object_received(int request_id, const QJsonObject& object, int provider);
+    void on_analysis_batch_finished(int request_id, const QString& content, qint64 elapsed_ms, int provider);
+    bool accept_batch_suggestion(AnalysisBatch& batch, const AiFileSuggestion& suggestion);
+    void on_analysis_batch_failed(int request_id, const QString& error);
+    void log_analysis(const QString& message);
+    // Per-provider requests, latency and throughput for the finished run
+    void log_provider_stats();
+    void finish_ai_analysis();
 
-    // Build the prompt for the AI
-    QString build_analysis_prompt(const QStringList& file_descriptions,
-                                  const QStringList& available_folders);
+    // One prompt line per file: index|name|size|type code[|content hint].
+    // With `previous_name` the name may take the "~N:" shared-prefix form;
+    // the prompt and the batch token estimate both use this.
+    QString describe_file(int file_index, const QString& previous_name = QString()) const;
+
+    // Classification cache: files are matched by name/extension/size/MIME
+    // under a key covering model, category settings and the folder set
+    QString classification_fingerprint(int file_index) const;
+    QString classification_config_key() const;
+    // Skipped for batches a fallback provider answered
+    void save_batch_to_cache(const AnalysisBatch& batch);
+    static QString suggestion_to_json(const AiFileSuggestion& suggestion);
+    // Moves cache hits into suggestions_ and drops them from file_indices
+    int take_cached_classifications(std::vector<int>& file_indices);
+    // Same for files the local naive-Bayes model assigns with high confidence
+    int take_local_classifications(std::vector<int>& file_indices);
+
+    // Prompt = preamble (instructions, folder IDs; identical for every batch
+    // so providers can cache it) + the batch's file lines
+    QString build_analysis_preamble(const QStringList& available_folders) const;
+    QString build_batch_prompt(const QList<int>& file_indices) const;
+    QString folder_display_path(const QString& folder) const;
+    // Map an answer's "F3" or relative path back to an absolute folder
+    QString resolve_folder_reference(const QString& reference) const;
+    static QString compact_size(qint64 bytes);
+    static QChar mime_code(const QString& mime_type, const QString& extension);
 
     // Parse AI response into suggestions
     std::vector<AiFileSuggestion> parse_ai_response(const QString& response);
-
-    // Send one batch to the API and return the response text (blocking)
-    QString send_api_request(const QString& prompt, QString& error_out);
+    // One {"i","f","c","r"} object; file_index is -1 when out of range
+    AiFileSuggestion parse_suggestion_object(const QJsonObject& obj) const;
 
     // Apply auto-mode suggestions (set decisions, go to review)
     void apply_auto_suggestions();
@@ -175,10 +252,6 @@ private:
     void highlight_suggested_folders(const QStringList& folders);
     void clear_folder_highlights();
     void on_folder_clicked_from_ai(const QString& folder_path);
-
-    // Rate limiting
-    bool check_rate_limit();
-    void reset_rate_limit();
 };
 
 #endif // AI_FILE_TINDER_DIALOG_HPP
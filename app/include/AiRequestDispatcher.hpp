@@ -0,0 +1,211 @@
+#ifndef AI_REQUEST_DISPATCHER_HPP
+#define AI_REQUEST_DISPATCHER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QNetworkRequest>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QSet>
+#include <deque>
+#include <vector>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+// Stores an AI provider configuration
+struct AiProviderConfig {
+    QString provider_name;
+    QString api_key;
+    QString endpoint_url;
+    QString model_name;
+    bool is_local = false;
+    int rate_limit_rpm = 60;
+    int rate_limit_tpm = 0;   // Prompt tokens per minute; 0 = no token budget
+    int max_concurrent = 4;   // Requests in flight at once
+    bool is_free_tier = false;
+    bool streaming = true;    // Request server-sent events where supported
+};
+
+// Incremental parser for a streamed JSON array of objects. Text is fed in
+// arbitrary chunks; each top-level object is returned as soon as its
+// closing brace arrives. Anything before the opening bracket (markdown
+// fences, preamble) is skipped.
+class JsonArrayStreamParser {
+public:
+    QList<QJsonObject> feed(QStringView chunk);
+    void reset();
+
+private:
+    int depth_ = 0;
+    bool in_string_ = false;
+    bool escape_ = false;
+    QString current_;
+};
+
+// Classic token bucket: holds up to `capacity` tokens, refilled at a
+// constant rate. A capacity of 0 means unlimited.
+class TokenBucket {
+public:
+    void configure(double capacity, double refill_per_minute);
+    bool try_take(double amount);
+    // Milliseconds until `amount` tokens will be available
+    int wait_ms(double amount);
+
+private:
+    void refill();
+
+    double capacity_ = 0.0;
+    double tokens_ = 0.0;
+    double refill_per_ms_ = 0.0;
+    qint64 last_refill_ms_ = 0;
+};
+
+// Throughput figures for one provider in the pool
+struct AiProviderStats {
+    QString name;               // "provider / model"
+    int completed = 0;
+    int failed = 0;
+    int throttled = 0;          // 429 responses
+    qint64 prompt_tokens = 0;   // Estimated, for completed requests
+    double avg_latency_ms = 0.0;
+    bool down = false;          // In failover cooldown right now
+};
+
+// Asynchronous request dispatcher for the AI providers. Keeps several
+// requests in flight, limited per provider by a requests-per-minute
+// bucket, a tokens-per-minute bucket and a concurrency cap that halves
+// on 429 and recovers on success. Retry-After is honoured per provider.
+// Replies are streamed (SSE) where the provider supports it, and array
+// elements are delivered as they complete.
+// With several providers configured, each request goes to the available
+// one with the lowest expected wait (measured latency x load); a request
+// that fails on one provider is retried on the others, and a provider
+// that keeps failing is benched for a cooldown.
+// Results are delivered per request as they arrive.
+class AiRequestDispatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AiRequestDispatcher(QObject* parent = nullptr);
+
+    void configure(const AiProviderConfig& config);
+    // First entry is the primary; the rest share load and take over on failure
+    void configure(const QList<AiProviderConfig>& pool);
+    const AiProviderConfig& config() const { return lanes_.front().config; }
+    int provider_count() const { return static_cast<int>(lanes_.size()); }
+    // Sum of the concurrency caps across the pool
+    int max_concurrency() const;
+
+    // Queue a prompt; returns the request id used in the signals.
+    // `cacheable_prefix` is sent ahead of the prompt and marked for
+    // provider-side prompt caching where the API supports it
+    int submit(const QString& prompt, int estimated_tokens, const QString& cacheable_prefix = QString());
+    // Drop queued requests and abort the ones in flight
+    void cancel_all();
+
+    int queued_count() const { return static_cast<int>(queue_.size()); }
+    int in_flight_count() const { return in_flight_; }
+    bool is_idle() const { return queue_.empty() && in_flight_ == 0; }
+
+    QList<AiProviderStats> provider_stats() const;
+
+    // Provider request shapes (OpenAI-compatible, Anthropic, Gemini)
+    static QNetworkRequest build_request(const AiProviderConfig& config, const QString& cacheable_prefix,
+                                         const QString& prompt, QByteArray& body_out);
+    static QString extract_content(const AiProviderConfig& config, const QByteArray& response);
+    // Rough prompt size: ~4 characters per token
+    static int estimate_tokens(const QString& text);
+    // Shortest prefix a provider caches; shorter prefixes are billed in full
+    // and not worth a cache marker (INT_MAX = no prompt caching)
+    static int min_cacheable_tokens(const QString& provider, const QString& model);
+    // Hash of the full prompt text (prefix + prompt), used as the record/replay key
+    static QByteArray prompt_key(const QString& full_prompt);
+
+    // Append every successful reply to this JSONL file (empty = off)
+    void set_record_path(const QString& path) { record_path_ = path; }
+
+signals:
+    // `provider` is the pool index that answered; 0 is the primary
+    // Streaming only: one array element, as soon as it has arrived
+    void object_received(int request_id, const QJsonObject& object, int provider);
+    void request_finished(int request_id, const QString& content, qint64 elapsed_ms, int provider);
+    void request_failed(int request_id, const QString& error);
+    void throttled(const QString& reason, int wait_ms);
+    // A provider was benched and its work moved to the rest of the pool
+    void provider_failed_over(const QString& provider, const QString& error);
+    void all_done();
+
+private:
+    struct PendingRequest {
+        int id = 0;
+        QString prefix;
+        QString prompt;
+        int tokens = 0;
+        int attempts = 0;           // 429 retries
+        QSet<int> failed_lanes;     // Providers this request already failed on
+    };
+
+    // One provider of the pool and its pacing state
+    struct Lane {
+        AiProviderConfig config;
+        TokenBucket request_bucket;
+        TokenBucket token_bucket;
+        int in_flight = 0;
+        int concurrency_limit = 1;
+        int successes_since_throttle = 0;
+        int consecutive_failures = 0;
+        qint64 hold_until_ms = 0;       // Retry-After pause
+        qint64 down_until_ms = 0;       // Failover cooldown
+        double latency_ms = 0.0;        // Moving average; 0 = not measured yet
+        AiProviderStats stats;
+    };
+
+    // Per-reply streaming state
+    struct ActiveReply {
+        int request_id = 0;
+        int lane = 0;
+        QByteArray sse_buffer;      // Bytes after the last complete line
+        QString content;            // Text deltas so far
+        JsonArrayStreamParser parser;
+        bool streamed = false;
+    };
+
+    void pump();
+    void schedule_pump(int delay_ms);
+    // Best lane for this request now, or -1 with `wait_ms` set to the
+    // earliest moment one could take it
+    int pick_lane(const PendingRequest& request, qint64 now, int& wait_ms);
+    void start_request(int lane, const PendingRequest& request);
+    void handle_reply(QNetworkReply* reply, PendingRequest request, qint64 started_ms);
+    // Move a failed request to another provider; false when none is left.
+    // Only provider faults (bench_lane) take the provider out of rotation.
+    bool fail_over(int lane, PendingRequest& request, const QString& error, bool bench_lane);
+    void handle_stream_data(QNetworkReply* reply);
+    // Text delta carried by one SSE data payload, per provider
+    static QString extract_stream_delta(const AiProviderConfig& config, const QJsonObject& event);
+    static int parse_retry_after(const QByteArray& header);
+    void record_response(const Lane& lane, const PendingRequest& request, const QString& content, qint64 elapsed_ms);
+
+    std::vector<Lane> lanes_;
+    QString record_path_;
+    QNetworkAccessManager* network_manager_;
+    QTimer* pump_timer_;
+    std::deque<PendingRequest> queue_;
+    QHash<QNetworkReply*, ActiveReply> replies_;   // In-flight replies
+
+    int next_id_ = 1;
+    int in_flight_ = 0;
+
+    static constexpr int kCloudTimeoutMs = 60000;
+    static constexpr int kLocalTimeoutMs = 120000;
+    static constexpr int kMaxBackoffSecs = 120;
+    static constexpr int kFailoverCooldownMs = 30000;
+    static constexpr int kMaxCooldownMs = 300000;
+    static constexpr double kLatencySmoothing = 0.3;
+};
+
+#endif // AI_REQUEST_DISPATCHER_HPP
@@ -0,0 +1,37 @@
+#ifndef ARCHIVE_INSPECTOR_HPP
+#define ARCHIVE_INSPECTOR_HPP
+
+#include <QString>
+#include <QStringList>
+
+struct ArchiveSummary {
+    QString format;               // "ZIP", "TAR", "TAR.GZ"
+    int entry_count = 0;
+    quint64 total_uncompressed = 0;
+    QStringList top_level;        // First path components, in archive order
+    bool partial = false;         // Stopped at a read budget; counts are lower bounds
+    bool valid = false;
+};
+
+// Lists archive contents without extracting. Zip reads only the central
+// directory; tar walks the 512-byte headers and seeks over file data.
+// Gzipped tars are streamed through zlib up to a decompression budget.
+// Blocking; call from a worker thread.
+class ArchiveInspector {
+public:
+    static bool can_inspect(const QString& file_path);
+    static ArchiveSummary inspect(const QString& file_path);
+    static QString format_for_display(const ArchiveSummary& summary);
+
+private:
+    static ArchiveSummary inspect_zip(const QString& file_path);
+    static ArchiveSummary inspect_tar(const QString& file_path);
+    static ArchiveSummary inspect_tar_gz(const QString& file_path);
+    static void add_entry(ArchiveSummary& summary, const QString& name, quint64 size);
+
+    static constexpr int kMaxTarEntries = 50000;
+    static constexpr qint64 kMaxGzipInflateBytes = 64 * 1024 * 1024;
+    static constexpr int kTopLevelShown = 15;
+};
+
+#endif // ARCHIVE_INSPECTOR_HPP
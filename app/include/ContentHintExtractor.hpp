@@ -0,0 +1,31 @@
+#ifndef CONTENT_HINT_EXTRACTOR_HPP
+#define CONTENT_HINT_EXTRACTOR_HPP
+
+#include <QString>
+#include <QByteArray>
+
+// Pulls a short, cheap description of a file's content for the AI prompt:
+// document titles (PDF info, Office/ODF core properties), EXIF date and
+// camera, ID3 artist/title/album, or the first words of a text file.
+// Reads at most a few tens of KB per file and never parses whole files.
+// Blocking and thread-safe; run from worker threads.
+class ContentHintExtractor {
+public:
+    // Empty when nothing useful was found
+    static QString extract(const QString& file_path, const QString& mime_type);
+
+    static constexpr int kMaxHintChars = 100;
+
+private:
+    static QString pdf_hint(const QString& file_path);
+    static QString office_hint(const QString& file_path);
+    static QString exif_hint(const QString& file_path);
+    static QString id3_hint(const QString& file_path);
+    static QString text_hint(const QString& file_path);
+
+    static QString clean(const QString& hint);
+
+    static constexpr qint64 kScanBytes = 64 * 1024;
+};
+
+#endif // CONTENT_HINT_EXTRACTOR_HPP
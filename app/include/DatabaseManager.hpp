@@ -5,6 +5,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QStringList>
+#include <QHash>
 #include <vector>
 #include <memory>
 
@@ -40,10 +41,14 @@ public:
     // File Tinder state management
     bool save_file_decision(const QString& session_folder, const QString& file_path, 
                            const QString& decision, const QString& destination = "");
+    // Many decisions in one transaction (timestamps are ignored)
+    bool save_file_decisions(const QString& session_folder, const std::vector<FileDecision>& decisions);
     std::vector<FileDecision> get_session_decisions(const QString& session_folder);
     bool clear_session(const QString& session_folder);
     FileDecision get_file_decision(const QString& session_folder, const QString& file_path);
     int get_session_progress_count(const QString& session_folder);
+    // Most recent "move" decisions across all sessions, newest first
+    std::vector<FileDecision> get_recent_move_decisions(int limit = 20000);
     
     // Folder tree management
     bool save_folder_tree_entry(const QString& session_folder, const FolderTreeEntry& entry);
@@ -88,6 +93,14 @@ public:
                         QString& endpoint_url, QString& model_name,
                         bool& is_local, int& rate_limit_rpm);
     QStringList get_ai_provider_names();
+
+    // AI classification cache: result JSON per file fingerprint, scoped to
+    // a prompt configuration key (model, category mode, folder set, ...)
+    QHash<QString, QString> get_ai_classifications(const QString& config_key,
+                                                   const QStringList& fingerprints);
+    bool save_ai_classifications(const QString& config_key,
+                                 const QHash<QString, QString>& results_by_fingerprint);
+    int prune_ai_classifications(int days_unused = 90);
     
     // Maintenance
     int cleanup_stale_sessions(int days_old = 30);
@@ -0,0 +1,53 @@
+#ifndef DECISION_RULE_ENGINE_HPP
+#define DECISION_RULE_ENGINE_HPP
+
+#include "FileQuery.hpp"
+#include <QString>
+#include <vector>
+
+struct FileToProcess;
+class FileSearchIndex;
+
+// One user rule: pending files matching `query` get `action`
+struct DecisionRule {
+    QString query;
+    QString action = "keep";   // "keep", "delete" or "move"
+    QString destination;       // For "move"; relative paths are under the source folder
+    bool enabled = true;
+};
+
+// Which rule claims each file, from a dry pass over the file list
+struct RuleMatchResult {
+    std::vector<int> rule_for_file;   // -1 = left for the user
+    std::vector<int> per_rule;        // Files claimed by each rule
+    int matched = 0;
+    qint64 elapsed_ms = 0;
+};
+
+// Ordered auto-decision rules. Each rule's query is compiled once; the
+// file list is split into one chunk per core and each chunk runs the
+// rules in order, so a file goes to the first rule that matches it and
+// later rules only see what is still unclaimed. Only pending files are
+// considered. Matching never changes the files; applying the result is
+// up to the caller.
+class DecisionRuleEngine {
+public:
+    // False, with `error` naming the rule, when an enabled rule is invalid
+    bool set_rules(const std::vector<DecisionRule>& rules, QString* error = nullptr);
+    const std::vector<DecisionRule>& rules() const { return rules_; }
+
+    RuleMatchResult match(const std::vector<FileToProcess>& files, const FileQuery::Columns& columns,
+                          const FileSearchIndex* index) const;
+
+    // Rule list persisted in the app settings
+    static std::vector<DecisionRule> load_rules();
+    static void save_rules(const std::vector<DecisionRule>& rules);
+
+private:
+    std::vector<DecisionRule> rules_;
+    std::vector<FileQuery> queries_;   // Parallel to rules_
+
+    static constexpr int kMinChunkFiles = 4096;
+};
+
+#endif // DECISION_RULE_ENGINE_HPP
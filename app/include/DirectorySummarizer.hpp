@@ -0,0 +1,37 @@
+#ifndef DIRECTORY_SUMMARIZER_HPP
+#define DIRECTORY_SUMMARIZER_HPP
+
+#include <QString>
+#include <QDateTime>
+#include <QList>
+#include <QPair>
+
+struct DirectorySummary {
+    int file_count = 0;      // Direct children
+    int dir_count = 0;
+    int total_files = 0;     // Whole subtree
+    qint64 total_size = 0;
+    QDateTime newest_mtime;
+    QList<QPair<QString, int>> top_types;  // (extension, count), most common first
+    bool partial = false;    // Walk stopped at the entry or time budget
+};
+
+// Walks a directory tree to build a preview summary. Bounded by entry
+// count and wall time so huge trees return a partial result quickly.
+// Blocking; call from a worker thread.
+class DirectorySummarizer {
+public:
+    static DirectorySummary summarize(const QString& dir_path);
+
+    // Multi-line text for the Basic mode card
+    static QString format_for_display(const DirectorySummary& summary);
+    // Single line for the Advanced mode details row
+    static QString format_brief(const DirectorySummary& summary);
+
+private:
+    static constexpr int kMaxEntries = 200000;
+    static constexpr int kMaxWalkMs = 3000;
+    static constexpr int kTopTypes = 5;
+};
+
+#endif // DIRECTORY_SUMMARIZER_HPP
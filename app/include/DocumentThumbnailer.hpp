@@ -0,0 +1,38 @@
+#ifndef DOCUMENT_THUMBNAILER_HPP
+#define DOCUMENT_THUMBNAILER_HPP
+
+#include <QString>
+#include <QImage>
+#include <QSize>
+#include <functional>
+
+// First-page previews for documents: PDFs are rendered with Qt PDF when
+// built with it; OOXML (docx/xlsx/pptx) and ODF files use the thumbnail
+// their authoring app embedded in the zip container.
+// Blocking; call from a worker thread.
+class DocumentThumbnailer {
+public:
+    static bool can_render(const QString& file_path, const QString& mime_type);
+    static QImage render(const QString& file_path, const QString& mime_type, const QSize& max_size);
+
+    // render() in a child process of this executable, killed after
+    // timeout_ms or as soon as `cancelled` returns true, so a document that
+    // hangs the renderer never holds the calling thread.
+    static QImage render_isolated(const QString& file_path, const QString& mime_type, const QSize& max_size,
+                                  int timeout_ms, const std::function<bool()>& cancelled = nullptr);
+
+    // Child side of render_isolated(): main() hands over when argv[1] is
+    // kRenderHelperFlag; writes the page as PNG to stdout
+    static constexpr const char* kRenderHelperFlag = "--render-document-preview";
+    static int run_render_helper(int argc, char* argv[]);
+
+private:
+    static bool is_pdf(const QString& file_path, const QString& mime_type);
+    static QImage render_pdf(const QString& file_path, const QSize& max_size);
+    static QImage extract_embedded_thumbnail(const QString& file_path, const QSize& max_size);
+
+    static constexpr qint64 kMaxThumbnailBytes = 4 * 1024 * 1024;
+    static constexpr int kHelperPollMs = 50;
+};
+
+#endif // DOCUMENT_THUMBNAILER_HPP
@@ -0,0 +1,54 @@
+#ifndef FILE_LIST_MODEL_HPP
+#define FILE_LIST_MODEL_HPP
+
+#include <QAbstractListModel>
+#include <QString>
+#include <vector>
+
+struct FileToProcess;
+class FileSearchIndex;
+
+// List model over the dialog's file vector, in filtered order. Rows are
+// plain ints into that order; text, colours and fonts are produced on
+// demand in data(), so only the rows on screen cost anything beyond
+// four bytes. With a search index the name filter is answered by the
+// index; without one, a filter that extends the previous one is applied
+// to the surviving rows only.
+class FileListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        FileIndexRole = Qt::UserRole + 200,   // Index into the file vector
+        FilteredIndexRole                     // Position in the filtered order
+    };
+
+    explicit FileListModel(std::vector<FileToProcess>& files, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    void set_order(const std::vector<int>& filtered_indices, int current_index);
+    // Index over the same file vector; null falls back to plain matching
+    void set_search_index(const FileSearchIndex* index) { search_index_ = index; }
+    void set_name_filter(const QString& text);
+    // Decisions changed in place; repaint without rebuilding rows
+    void refresh_rows();
+
+    int total_count() const { return static_cast<int>(filtered_indices_.size()); }
+    // Row showing the current file, or -1 when it is filtered out
+    int current_row() const;
+
+private:
+    void rebuild_rows();
+
+    std::vector<FileToProcess>& files_;
+    std::vector<int> filtered_indices_;
+    std::vector<int> rows_;   // Positions in filtered_indices_ that pass the filter
+    QString filter_;
+    int current_index_ = -1;
+    const FileSearchIndex* search_index_ = nullptr;
+};
+
+#endif // FILE_LIST_MODEL_HPP
@@ -2,17 +2,20 @@
 #define FILE_LIST_WINDOW_HPP
 
 #include <QDialog>
-#include <QListWidget>
+#include <QListView>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QTimer>
 #include <vector>
 
 struct FileToProcess;
+class FileListModel;
+class FileSearchIndex;
 
 // Separate file list window that spans all modes.
 // Replaces the "search files" feature with a full file browser:
-// - Shows all files in order (filterable)
+// - Shows all files in order (filterable, virtualized for large folders)
 // - Multi-select with Shift/Ctrl+click
 // - Drag-and-drop to grid folders
 // - Click to navigate to file in main view
@@ -23,6 +26,7 @@ public:
     explicit FileListWindow(std::vector<FileToProcess>& files,
                             const std::vector<int>& filtered_indices,
                             int current_index,
+                            const FileSearchIndex* search_index = nullptr,
                             QWidget* parent = nullptr);
 
     void refresh(const std::vector<int>& filtered_indices, int current_index);
@@ -34,18 +38,18 @@ signals:
 
 private:
     void build_ui();
-    void update_list();
+    void update_counts();
     void on_filter_changed(const QString& text);
-    void on_item_clicked(QListWidgetItem* item);
-    void on_item_double_clicked(QListWidgetItem* item);
+    void on_item_clicked(const QModelIndex& index);
+    void on_item_double_clicked(const QModelIndex& index);
+    QList<int> selected_file_indices() const;
 
-    std::vector<FileToProcess>& files_;
-    std::vector<int> filtered_indices_;
-    int current_index_;
     QStringList destination_folders_;
 
+    FileListModel* model_;
     QLineEdit* filter_edit_;
-    QListWidget* list_widget_;
+    QTimer* filter_timer_;          // Debounces typing in the filter
+    QListView* list_view_;
     QLabel* count_label_;
     QLabel* selection_label_;
 };
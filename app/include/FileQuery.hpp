@@ -0,0 +1,69 @@
+#ifndef FILE_QUERY_HPP
+#define FILE_QUERY_HPP
+
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+struct FileToProcess;
+class FileSearchIndex;
+
+// Compact filter expressions over the scanned files, e.g.
+//
+//   type:video size>2GB age>2y
+//   name:IMG_* is:duplicate
+//   (ext:jpg,png or type:image) -decision:delete
+//
+// Terms are ANDed; "or", "not"/"-" and parentheses combine them.
+// Fields: size (B/KB/MB/GB/TB), age (h/d/w/m/y), modified (yyyy-MM-dd),
+// type (image, video, audio, document, archive, folder, other),
+// ext, name (substring, glob, or /regex/), decision, and
+// is:duplicate / is:folder / is:file. A bare word matches the name.
+//
+// A query is compiled once; evaluation runs column by column over the
+// whole file list, so numeric fields are plain loops over flat arrays.
+class FileQuery {
+public:
+    // Flat per-file columns for the fields that never change after a scan
+    struct Columns {
+        std::vector<qint64> size;
+        std::vector<qint64> mtime;          // Seconds since epoch; 0 = unknown
+        std::vector<quint8> category;       // One category bit per file
+        std::vector<quint8> flags;          // kFolderFlag | kDuplicateFlag
+
+        void build(const std::vector<FileToProcess>& files);
+        void clear();
+        int count() const { return static_cast<int>(size.size()); }
+    };
+
+    // Empty text compiles to an empty query that matches everything
+    static FileQuery compile(const QString& text);
+
+    bool is_valid() const { return error_.isEmpty(); }
+    bool is_empty() const { return !root_; }
+    const QString& error() const { return error_; }
+    const QString& text() const { return text_; }
+
+    // One byte per file: 1 where the file matches. `index` speeds up name
+    // terms when it covers the same file list
+    std::vector<quint8> evaluate(const std::vector<FileToProcess>& files, const Columns& columns,
+                                 const FileSearchIndex* index = nullptr) const;
+    // Same for files [begin, end) only; result[0] is file `begin`. Const
+    // and safe to call for disjoint ranges from several threads
+    std::vector<quint8> evaluate(const std::vector<FileToProcess>& files, const Columns& columns,
+                                 const FileSearchIndex* index, int begin, int end) const;
+
+    static constexpr quint8 kFolderFlag = 0x1;
+    static constexpr quint8 kDuplicateFlag = 0x2;
+
+private:
+    struct Node;
+    class Parser;
+
+    std::shared_ptr<const Node> root_;
+    QString text_;
+    QString error_;
+};
+
+#endif // FILE_QUERY_HPP
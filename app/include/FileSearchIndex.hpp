@@ -0,0 +1,54 @@
+#ifndef FILE_SEARCH_INDEX_HPP
+#define FILE_SEARCH_INDEX_HPP
+
+#include <QString>
+#include <QStringView>
+#include <QHash>
+#include <vector>
+
+struct FileToProcess;
+
+// In-memory name index built once per scan and shared by the search box
+// and the file list filter. Names are case-folded and stripped of accents
+// into one contiguous buffer; a trigram index narrows substring, prefix
+// and glob queries to a handful of candidates before the exact check.
+// Fuzzy (in-order subsequence) queries scan the buffer directly.
+//
+// Query syntax: "^abc" prefix, "~abc" fuzzy, any '*' or '?' makes it a
+// glob over the whole name, anything else is a substring.
+class FileSearchIndex {
+public:
+    enum class MatchMode { Substring, Prefix, Glob, Fuzzy };
+
+    void build(const std::vector<FileToProcess>& files);
+    void clear();
+    int size() const { return static_cast<int>(offsets_.empty() ? 0 : offsets_.size() - 1); }
+
+    // Sorted file indices whose name matches
+    std::vector<int> find(const QString& query) const;
+    std::vector<int> find(const QString& term, MatchMode mode) const;
+    // Per file index: true where the name matches. Sized to size()
+    std::vector<bool> match_mask(const QString& query) const;
+
+    static MatchMode mode_for(const QString& query, QString* term = nullptr);
+    // Case-folded, accent-free form used for both names and queries
+    static QString normalize(const QString& text);
+
+private:
+    QStringView name_at(int file_index) const;
+    // Files containing every trigram of `literal`; false (and `out` left
+    // empty) when the literal is too short to narrow anything
+    bool candidates(QStringView literal, std::vector<int>& out) const;
+    // Substring search straight over the buffer, for short needles
+    std::vector<int> scan(QStringView needle) const;
+
+    static quint64 trigram_key(const QChar* p) {
+        return (quint64(p[0].unicode()) << 32) | (quint64(p[1].unicode()) << 16) | quint64(p[2].unicode());
+    }
+
+    QString text_;                  // Normalized names, back to back
+    std::vector<int> offsets_;      // Start of each name in text_, plus end
+    QHash<quint64, std::vector<int>> trigrams_;   // Trigram -> sorted file indices
+};
+
+#endif // FILE_SEARCH_INDEX_HPP
@@ -9,9 +9,32 @@
 struct ExecutionPlan {
     std::vector<QString> files_to_delete;
     std::vector<std::pair<QString, QString>> files_to_move;  // source, dest
+    std::vector<std::pair<QString, QString>> files_to_copy;  // source, dest
     std::vector<QString> folders_to_create;
 };
 
+// Bytes a plan would write to one storage device
+struct DeviceEstimate {
+    QString root;               // Mount point
+    qint64 bytes_to_write = 0;
+    qint64 bytes_available = -1;
+    int files = 0;
+};
+
+// What executing a plan would do, worked out without touching any file
+struct DryRunReport {
+    ExecutionPlan resolved_plan;   // Move/copy destinations are full, collision-free file paths
+    QStringList problems;          // Operations that would fail
+    QStringList warnings;          // Would succeed, but maybe not as expected
+    int renamed = 0;               // Files given a numbered name to avoid a collision
+    int cross_device = 0;          // Moves that need copy + delete
+    qint64 bytes_to_copy = 0;
+    qint64 estimated_ms = 0;
+    std::vector<DeviceEstimate> devices;
+    
+    bool has_problems() const { return !problems.isEmpty(); }
+};
+
 // Record of a single executed action for undo support
 struct ExecutionLogEntry {
     QString action;            // "move", "delete", "folder_create"
@@ -23,6 +46,7 @@ struct ExecutionLogEntry {
 struct ExecutionResult {
     int files_deleted = 0;
     int files_moved = 0;
+    int files_copied = 0;
     int folders_created = 0;
     int errors = 0;
     QStringList error_messages;
@@ -39,6 +63,12 @@ public:
     
     ExecutionResult execute(const ExecutionPlan& plan, ProgressCallback progress_callback = nullptr);
     
+    // Dry run: resolves name collisions against one listing per destination
+    // folder, checks sources, permissions and free space, and estimates bytes
+    // and duration. Executing resolved_plan moves files to exactly the
+    // reported names unless the disk changes in between.
+    DryRunReport simulate(const ExecutionPlan& plan) const;
+    
     // Undo a single executed action (move back / restore from trash)
     static bool undo_action(const ExecutionLogEntry& entry);
     
@@ -54,8 +84,13 @@ private:
                        ProgressCallback callback, int& progress, int total);
     bool move_files(const std::vector<std::pair<QString, QString>>& moves, 
                    ExecutionResult& result, ProgressCallback callback, int& progress, int total);
+    bool copy_files(const std::vector<std::pair<QString, QString>>& copies,
+                   ExecutionResult& result, ProgressCallback callback, int& progress, int total);
     bool delete_files(const std::vector<QString>& files, ExecutionResult& result,
                      ProgressCallback callback, int& progress, int total);
+    // Final path for a move/copy: joins folder destinations with the file
+    // name and picks a numbered name if the target exists
+    bool prepare_dest_path(const QString& source, const QString& dest, QString& dest_path) const;
     bool move_to_trash(const QString& file_path, QString& trash_path);
 };
 
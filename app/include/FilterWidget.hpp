@@ -57,6 +57,7 @@ public:
     SortOrder get_sort_order() const;
     bool get_include_folders() const;
     QStringList get_custom_extensions() const;
+    QString get_query_text() const;
 
     // Setters
     void set_filter_type(FileFilterType type);
@@ -64,11 +65,15 @@ public:
     void set_sort_order(SortOrder order);
     void set_include_folders(bool include);
     void set_custom_extensions(const QStringList& extensions);
+    // Empty clears the error state
+    void set_query_error(const QString& error);
 
 signals:
     void filter_changed();
     void sort_changed();
     void include_folders_changed(bool include);
+    // Enter pressed in the query box, or the box was cleared
+    void query_changed(const QString& text);
 
 private slots:
     void on_filter_changed(int index);
@@ -84,6 +89,7 @@ private:
     QComboBox* sort_combo_;
     QPushButton* sort_order_btn_;
     QCheckBox* include_folders_check_;
+    QLineEdit* query_edit_;
     
     FileFilterType current_filter_;
     SortField current_sort_field_;
@@ -4,6 +4,8 @@
 #include <QAbstractItemModel>
 #include <QString>
 #include <QStringList>
+#include <QHash>
+#include <QTimer>
 #include <vector>
 #include <memory>
 
@@ -63,9 +65,13 @@ public:
     void connect_folders(const QStringList& paths, int group_id = -1);
     void disconnect_folder(const QString& path);
     
-    // File assignment
+    // File assignment. Counts change immediately; the change signals are
+    // coalesced and go out once per frame (or on flush_count_changes)
     void assign_file_to_folder(const QString& folder_path);
     void unassign_file_from_folder(const QString& folder_path);
+    // Bulk form: net count change per folder path, applied in one pass
+    void apply_assignment_deltas(const QHash<QString, int>& deltas);
+    void flush_count_changes();
     void clear_assignments();
     
     // Getters
@@ -89,13 +95,20 @@ public:
 signals:
     void folder_assigned(const QString& folder_path);
     void folder_structure_changed();
+    // Assigned file counts changed for these folders since the last flush
+    void folder_counts_changed(const QStringList& folder_paths);
     
 private:
     std::unique_ptr<FolderNode> root_;
     int next_connection_group_id_;
+    // Every node in the tree by path, kept in step with add/remove/reset
+    QHash<QString, FolderNode*> path_index_;
+    // Net count change per folder since the last flush
+    QHash<QString, int> pending_count_deltas_;
+    QTimer* count_flush_timer_;
     
-    void scan_directory(FolderNode* parent, const QString& path, int depth = 0);
-    FolderNode* find_node_recursive(FolderNode* node, const QString& path) const;
+    void note_count_change(FolderNode* node, int delta);
+    void unindex_subtree(FolderNode* node);
     QModelIndex index_for_node(FolderNode* node) const;
     void collect_virtual_folders(FolderNode* node, QStringList& result) const;
 };
@@ -0,0 +1,51 @@
+#ifndef LOCAL_PRE_CLASSIFIER_HPP
+#define LOCAL_PRE_CLASSIFIER_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+
+struct PreClassification {
+    QString folder;          // Empty when no folder is confident enough
+    double confidence = 0.0; // Posterior probability of `folder`
+    int support = 0;         // Training examples seen for `folder`
+    QStringList alternates;  // Next most likely folders
+};
+
+// Multinomial naive Bayes over filename features: word and digit-run
+// tokens, token bigrams, extension and MIME type/category. Trained on
+// past move decisions and AI corrections, it assigns files whose naming
+// pattern strongly matches one destination so they can skip the LLM.
+class LocalPreClassifier {
+public:
+    void add_example(const QString& file_name, const QString& mime_type, const QString& folder);
+    // Restrict predictions to these folders (the current folder set)
+    void set_allowed_folders(const QStringList& folders);
+
+    PreClassification classify(const QString& file_name, const QString& mime_type) const;
+    // classify() result passes the confidence and support thresholds
+    bool is_confident(const PreClassification& result) const;
+
+    int example_count() const { return total_examples_; }
+
+    static QStringList features(const QString& file_name, const QString& mime_type);
+
+    static constexpr double kAcceptConfidence = 0.92;
+    static constexpr int kMinSupport = 3;
+
+private:
+    struct FolderStats {
+        int examples = 0;
+        int feature_total = 0;
+        QHash<QString, int> feature_counts;
+    };
+
+    QHash<QString, FolderStats> folders_;
+    QHash<QString, int> vocabulary_;   // feature -> total count across folders
+    QStringList allowed_;
+    int allowed_known_ = 0;   // Allowed folders with at least one example
+    int total_examples_ = 0;
+};
+
+#endif // LOCAL_PRE_CLASSIFIER_HPP
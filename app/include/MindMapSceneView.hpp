@@ -0,0 +1,100 @@
+#ifndef MIND_MAP_SCENE_VIEW_HPP
+#define MIND_MAP_SCENE_VIEW_HPP
+
+#include <QGraphicsView>
+#include <QGraphicsItem>
+#include <QStaticText>
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <vector>
+
+class QGraphicsScene;
+struct FolderNode;
+
+// One folder cell: a painted rounded rect with a cached caption. No
+// widget, no stylesheet, no event handling of its own.
+class FolderMapItem : public QGraphicsItem {
+public:
+    FolderMapItem(const QString& path, const QSizeF& size);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    const QString& path() const { return path_; }
+    void set_size(const QSizeF& size);
+    // Caption and style state as computed by FolderButton; the caption is
+    // re-laid out only when it actually changes
+    void set_content(const QString& label, const QString& state, const QString& custom_color, int font_px);
+    void set_selected(bool selected);
+    void set_label(const QString& label);
+
+private:
+    void prepare_text();
+
+    QString path_;
+    QSizeF size_;
+    QString label_;
+    QStaticText text_;
+    QFont font_;
+    QString state_;
+    QColor custom_color_;
+    int font_px_ = 10;
+    bool selected_ = false;
+};
+
+// QGraphicsView renderer for the destination map, used by MindMapView
+// for large folder sets. Cells are placed on the same grid as the widget
+// renderer; the scene's BSP index culls everything off screen, and text
+// is skipped when zoomed far out. Ctrl+wheel zooms, dragging pans.
+class MindMapSceneView : public QGraphicsView {
+    Q_OBJECT
+
+public:
+    explicit MindMapSceneView(QWidget* parent = nullptr);
+
+    // Bring the scene in line with the grid computed by MindMapView.
+    // `cells` maps folder path -> (row, col); the root spans `root_rows`.
+    void sync(FolderNode* root, const std::vector<FolderNode*>& nodes,
+              const QMap<QString, QPair<int, int>>& cells, int root_rows,
+              QPair<int, int> add_cell, const QSizeF& cell_size, bool show_full_paths, int root_font_px);
+    void set_selected_path(const QString& path);
+    // Caption change only, e.g. a new assigned file count
+    void update_label(const QString& path, const QString& label);
+    void ensure_path_visible(const QString& path);
+
+    void zoom_by(double factor);
+    void zoom_fit();
+
+signals:
+    void folder_clicked(const QString& path);
+    void folder_context_menu(const QString& path, const QPoint& global_pos);
+    void add_folder_requested();
+
+protected:
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void contextMenuEvent(QContextMenuEvent* event) override;
+
+private:
+    FolderMapItem* item_at(const QPoint& view_pos) const;
+    QPointF cell_origin(int row, int col) const;
+
+    QGraphicsScene* scene_;
+    QHash<QString, FolderMapItem*> items_;
+    FolderMapItem* add_item_ = nullptr;
+    QString selected_path_;
+    QSizeF cell_size_;
+    QPoint press_pos_;
+
+    static constexpr double kCellSpacing = 4.0;
+    static constexpr double kMargin = 6.0;
+    static constexpr double kMinZoom = 0.1;
+    static constexpr double kMaxZoom = 4.0;
+};
+
+#endif // MIND_MAP_SCENE_VIEW_HPP
@@ -8,9 +8,12 @@
 #include <QMap>
 #include <QString>
 #include <QPoint>
+#include <QTimer>
+#include <vector>
 
 class FolderTreeModel;
 class FolderNode;
+class MindMapSceneView;
 
 // Folder cell used in the mind map grid
 class FolderButton : public QPushButton {
@@ -20,10 +23,20 @@ public:
     FolderButton(FolderNode* node, QWidget* parent = nullptr);
     
     FolderNode* node() const { return node_; }
+    const QString& path() const { return path_; }
     void set_selected(bool selected);
+    void set_root(bool root);
     void update_display();
+    // Re-read name, count and state from the node
+    void refresh_appearance();
     void set_show_full_path(bool show) { show_full_path_ = show; update_display(); }
     
+    // Shared with the scene renderer: caption for a folder cell of the
+    // given pixel width, and its style state ("selected", "root", "custom",
+    // "virtual", "external" or "normal")
+    static QString label_for(const FolderNode* node, bool show_full_path, int width_px);
+    static QString state_for(const FolderNode* node, bool selected, bool root);
+    
 signals:
     void folder_clicked(const QString& path);
     void folder_right_clicked(const QString& path, const QPoint& global_pos);
@@ -36,10 +49,14 @@ protected:
     
 private:
     FolderNode* node_;
+    QString path_;              // Copy, so queued signals stay valid after the node is gone
     bool is_selected_;
+    bool is_root_ = false;
     QPoint drag_start_pos_;
     bool show_full_path_ = false;
+    QString style_state_;       // Current folderState property for the shared stylesheet
     
+    // Switches the folderState property; only custom colours need their own stylesheet
     void update_style();
 };
 
@@ -52,7 +69,13 @@ public:
     ~MindMapView() override;
     
     void set_model(FolderTreeModel* model);
+    // Bring the grid in line with the model, reusing buttons that still
+    // match a folder and only moving the ones whose cell changed
     void refresh_layout();
+    // Coalesce a burst of structure changes into one refresh_layout()
+    void schedule_refresh();
+    // Re-label only the cells whose assigned file count changed
+    void update_folder_counts(const QStringList& folder_paths);
     void zoom_in();
     void zoom_out();
     void zoom_fit();
@@ -76,18 +99,36 @@ private:
     FolderTreeModel* model_;
     QMap<QString, FolderButton*> buttons_;
     QPushButton* add_button_;
+    QTimer* refresh_timer_;
+    QString grid_style_;            // Shared stylesheet currently on content_widget_
+    // Painted renderer for large maps (or always, with mindMap/sceneRenderer)
+    MindMapSceneView* scene_view_ = nullptr;
+    bool prefer_scene_ = false;
+    bool scene_active_ = false;
     
     // Grid position tracking: maps folder path to (row, col)
     QMap<QString, QPair<int, int>> grid_positions_;
+    QPair<int, int> add_button_pos_{-1, -1};
+    int root_row_span_ = 0;
     int next_row_;
     int next_col_;
     int max_rows_per_col_ = 6;  // Configurable items per column before wrapping
     bool compact_mode_ = true;  // Compact (small) vs expanded (wider) folder buttons
     bool show_full_paths_ = false;
     int custom_width_ = 0;  // 0 = use compact/expanded defaults
+    static constexpr int kSceneFolderThreshold = 300;  // Switch to the painted renderer from here
     
-    void build_grid();
-    void place_folder_node(FolderNode* node);
+    void ensure_content_widget();
+    void release_content_widget();
+    void refresh_widgets(FolderNode* root, const std::vector<FolderNode*>& nodes);
+    void refresh_scene(FolderNode* root, const std::vector<FolderNode*>& nodes);
+    void advance_cell();
+    QSize cell_size() const;
+    FolderButton* take_or_create_button(FolderNode* node, QMap<QString, FolderButton*>& previous);
+    void place_button(FolderButton* btn, int row, int col, bool is_new);
+    // Delete buttons whose node left the model, ahead of the deferred relayout
+    void drop_stale_buttons();
+    void collect_grid_nodes(FolderNode* node, std::vector<FolderNode*>& out) const;
     
 public:
     void set_max_rows_per_col(int rows) { max_rows_per_col_ = qMax(1, rows); }
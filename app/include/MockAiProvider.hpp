@@ -0,0 +1,71 @@
+#ifndef MOCK_AI_PROVIDER_HPP
+#define MOCK_AI_PROVIDER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QByteArray>
+#include <QRandomGenerator>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Behaviour knobs, read from QSettings "mockAi/*"
+struct MockAiOptions {
+    int latency_ms = 400;          // Base time to first byte
+    int jitter_ms = 200;           // Uniform extra latency
+    int rate_limit_every = 0;      // Every Nth request gets HTTP 429 (0 = never)
+    int retry_after_secs = 1;
+    int malformed_every = 0;       // Every Nth reply is prose-wrapped and cut short
+    QString replay_path;           // JSONL written by AiRequestDispatcher's record mode
+    quint32 seed = 1;              // Same seed, same answers and latencies
+
+    static MockAiOptions from_settings();
+};
+
+// In-process HTTP server that answers the OpenAI-compatible
+// (/chat/completions) and Anthropic (/messages) request shapes, plain or
+// streamed. Answers come from a replay file when the prompt was recorded,
+// otherwise they are synthesised deterministically from the file lines in
+// the prompt. Used for benchmarking and testing AI mode offline.
+class MockAiProvider : public QObject {
+    Q_OBJECT
+
+public:
+    static MockAiProvider& instance();
+
+    // Starts listening on 127.0.0.1 on first use; returns the base URL
+    QString ensure_started();
+    void set_options(const MockAiOptions& options);
+
+    int requests_served() const { return requests_served_; }
+
+    static constexpr const char* kProviderName = "Mock (Local)";
+
+private:
+    MockAiProvider();
+
+    struct Connection {
+        QByteArray buffer;
+        bool handled = false;
+    };
+
+    void on_new_connection();
+    void on_ready_read(QTcpSocket* socket);
+    void handle_request(QTcpSocket* socket, const QByteArray& path, const QByteArray& body);
+    void send_response(QTcpSocket* socket, bool anthropic, bool stream, const QString& content);
+    static void write_http(QTcpSocket* socket, int status, const QByteArray& content_type,
+                           const QByteArray& body, const QByteArray& extra_headers = QByteArray());
+
+    QString synthesize_answer(const QString& prompt);
+    void load_replay();
+
+    QTcpServer* server_ = nullptr;
+    QHash<QTcpSocket*, Connection> connections_;
+    QHash<QByteArray, QString> replay_;   // prompt hash -> recorded content
+    MockAiOptions options_;
+    QRandomGenerator rng_;
+    int requests_served_ = 0;
+};
+
+#endif // MOCK_AI_PROVIDER_HPP
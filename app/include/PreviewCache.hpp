@@ -0,0 +1,43 @@
+#ifndef PREVIEW_CACHE_HPP
+#define PREVIEW_CACHE_HPP
+
+#include <QString>
+#include <QImage>
+#include <QCache>
+#include <QMutex>
+
+// Process-wide cache for generated previews (thumbnails, filmstrips) and
+// text metadata (text excerpts, summaries).
+// Keys embed the file's size and mtime so edited files regenerate.
+// Thread-safe: preview workers write here, the GUI thread reads.
+class PreviewCache {
+public:
+    static PreviewCache& instance();
+
+    // Build a cache key for a file and preview kind ("video", "pdf", ...)
+    static QString make_key(const QString& file_path, const QString& kind);
+
+    // Thumbnail cache
+    bool get_image(const QString& key, QImage& out) const;
+    void put_image(const QString& key, const QImage& image);
+
+    // Text/metadata cache
+    bool get_text(const QString& key, QString& out) const;
+    void put_text(const QString& key, const QString& text);
+
+    void clear();
+
+private:
+    PreviewCache();
+    PreviewCache(const PreviewCache&) = delete;
+    PreviewCache& operator=(const PreviewCache&) = delete;
+
+    mutable QMutex mutex_;
+    QCache<QString, QImage> images_;  // cost in KB
+    QCache<QString, QString> texts_;  // cost in characters
+
+    static constexpr int kImageBudgetKb = 64 * 1024;
+    static constexpr int kTextBudgetChars = 4 * 1024 * 1024;
+};
+
+#endif // PREVIEW_CACHE_HPP
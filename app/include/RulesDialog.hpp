@@ -0,0 +1,47 @@
+#ifndef RULES_DIALOG_HPP
+#define RULES_DIALOG_HPP
+
+#include "DecisionRuleEngine.hpp"
+#include <QDialog>
+#include <QTableWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <vector>
+
+// Editor for the ordered auto-decision rules. "Preview" matches the rules
+// against the current files and shows how many each would decide;
+// "Apply" is only enabled for an up-to-date preview and accepts the
+// dialog, leaving engine() and result() for the caller to apply.
+class RulesDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    RulesDialog(const std::vector<FileToProcess>& files, const FileQuery::Columns& columns,
+                const FileSearchIndex* index, QWidget* parent = nullptr);
+
+    const DecisionRuleEngine& engine() const { return engine_; }
+    const RuleMatchResult& result() const { return result_; }
+
+private:
+    enum Column { EnabledColumn, QueryColumn, ActionColumn, DestinationColumn, MatchesColumn };
+
+    void build_ui();
+    void add_row(const DecisionRule& rule);
+    void move_selected_row(int delta);
+    std::vector<DecisionRule> rules_from_table() const;
+    void invalidate_preview();
+    void on_preview();
+    void on_apply();
+
+    const std::vector<FileToProcess>& files_;
+    const FileQuery::Columns& columns_;
+    const FileSearchIndex* index_;
+    DecisionRuleEngine engine_;
+    RuleMatchResult result_;
+
+    QTableWidget* table_;
+    QLabel* status_label_;
+    QPushButton* apply_btn_;
+};
+
+#endif // RULES_DIALOG_HPP
@@ -15,14 +15,24 @@
 #include <QStringList>
 #include <QDateTime>
 #include <QTimer>
+#include <QThreadPool>
+#include <QVariant>
+#include <QImage>
+#include <QHash>
 #include <vector>
+#include <utility>
 #include <memory>
+#include <atomic>
+#include <functional>
+#include "FileSearchIndex.hpp"
+#include "FileQuery.hpp"
 
 class DatabaseManager;
 class QPropertyAnimation;
 class QGraphicsOpacityEffect;
 class ImagePreviewWindow;
 struct ExecutionResult;
+struct DryRunReport;
 
 // Action record for undo functionality
 struct ActionRecord {
@@ -30,6 +40,9 @@ struct ActionRecord {
     QString previous_decision; // What the decision was before
     QString new_decision;      // What we changed it to
     QString destination_folder; // For move operations
+    // A rules pass: (file index, previous destination) of every file it
+    // decided, all previously pending; undone together
+    std::vector<std::pair<int, QString>> batch;
 };
 
 struct FileToProcess {
@@ -89,6 +102,7 @@ protected:
     // File management
     std::vector<FileToProcess> files_;
     std::vector<int> filtered_indices_;  // Indices into files_ after filtering
+    FileSearchIndex search_index_;       // Names of files_, see rebuild_search_index
     int current_filtered_index_;         // Current position in filtered list
     QString source_folder_;
     DatabaseManager& db_;
@@ -102,6 +116,10 @@ protected:
     QStringList custom_extensions_;
     bool include_folders_;
     
+    // Query filter, applied on top of the category filter
+    FileQuery filter_query_;
+    FileQuery::Columns query_columns_;   // Rebuilt with search_index_
+    
     // Statistics
     int keep_count_;
     int delete_count_;
@@ -126,6 +144,7 @@ protected:
     QComboBox* sort_combo_;        // Sort field selector
     QPushButton* sort_order_btn_;  // Asc/Desc toggle
     QCheckBox* folders_checkbox_;  // Include folders toggle
+    QLineEdit* query_edit_ = nullptr;
     QLabel* shortcuts_label_;
     QLabel* file_position_label_;
     QLabel* size_badge_label_;
@@ -148,6 +167,12 @@ protected:
     // Resize debounce timer
     QTimer* resize_timer_;
     
+    // Background preview generation. Each new file shown bumps the
+    // generation; queued or finished jobs from older files are dropped.
+    QThreadPool preview_pool_;
+    std::shared_ptr<std::atomic<int>> preview_generation_;
+    static constexpr int kDocumentPreviewTimeoutMs = 5000;   // Helper process is killed after this
+    
     // Close guard to prevent re-entrant close
     bool closing_ = false;
     bool animating_ = false;
@@ -164,10 +189,16 @@ protected:
     void apply_filter(FileFilterType filter);
     void rebuild_filtered_indices();
     bool file_matches_filter(const FileToProcess& file) const;
+    // Compile and apply a query; on a syntax error nothing changes
+    bool set_filter_query(const QString& text, QString* error = nullptr);
+    // Stay on the previous file if still visible, else the first pending one
+    void reposition_after_filter(int prev_file_idx);
     void show_custom_extension_dialog();  // New: custom extension picker
     
     // Sorting
     void apply_sort();
+    // Re-key search_index_ and query_columns_ after files_ changed
+    void rebuild_search_index();
     void on_sort_changed(int index);
     void on_sort_order_toggled();
     void on_folders_toggle_changed(int state);
@@ -175,6 +206,10 @@ protected:
     // File display
     virtual void show_current_file();
     void update_preview(const QString& file_path);
+    void run_preview_job(std::function<QVariant()> job, std::function<void(const QVariant&)> on_ready);
+    void show_preview_image(const QImage& image);
+    // Walks dir_path and caches both summary forms; call from the preview pool
+    static QString summarize_directory_cached(const QString& dir_path, bool brief);
     void update_file_info(const FileToProcess& file);
     void update_progress();
     void update_stats();
@@ -189,12 +224,19 @@ protected:
     virtual void on_back();
     virtual void on_search(const QString& text);
     virtual void on_undo();           // Undo last action
+    void undo_batch(const ActionRecord& action);  // Back to pending, in one transaction
     virtual void on_show_preview();   // Open image in separate window
     virtual void on_finish();
     void advance_to_next();
     void go_to_previous();
     void record_action(int file_index, const QString& old_decision, const QString& new_decision,
                        const QString& dest_folder = QString());
+    // Bulk move from the file list window
+    virtual void assign_files_to_folder(const QList<int>& indices, const QString& dest);
+    // Auto-decision rules: edit, preview, then apply in one pass
+    void show_rules_dialog();
+    // Files moved in bulk without per-file undo, counted per destination
+    virtual void on_bulk_moves(const QHash<QString, int>& moves_per_folder) { Q_UNUSED(moves_per_folder); }
     
     // Helper to update decision counts (deduplication)
     void update_decision_count(const QString& old_decision, int delta);
@@ -206,6 +248,7 @@ protected:
     // Review screen
     void show_review_summary();
     void execute_decisions();
+    bool show_dry_run_report(const DryRunReport& report);  // True to go ahead
     void show_execution_results(const ExecutionResult& result, qint64 elapsed_ms);
     virtual QStringList get_destination_folders() const;  // Grid folders for review dropdown
     
@@ -0,0 +1,42 @@
+#ifndef TEXT_PREVIEW_LOADER_HPP
+#define TEXT_PREVIEW_LOADER_HPP
+
+#include <QString>
+#include <QByteArray>
+
+class QFile;
+
+struct TextPreview {
+    QString text;          // Ready-to-display excerpt (head, plus tail for large files)
+    QString encoding;      // "UTF-8", "UTF-16LE", "Latin-1", ...
+    bool is_binary = false;
+    bool truncated = false;
+    bool has_tail = false;  // text ends with the file's last lines
+    qint64 file_size = 0;
+};
+
+// Bounded text preview. Memory-maps only the first and last few KB of the
+// file, so a multi-GB log costs the same as a small one. Blocking; call
+// from a worker thread.
+class TextPreviewLoader {
+public:
+    static TextPreview load(const QString& file_path);
+
+    // Formats a preview for the card label
+    static QString format_for_display(const TextPreview& preview);
+
+private:
+    static QByteArray read_window(QFile& file, qint64 offset, qint64 length);
+    static QString detect_encoding(const QByteArray& head, int& bom_length);
+    static bool looks_binary(const QByteArray& head, const QString& encoding);
+    static QString decode(const QByteArray& bytes, const QString& encoding);
+    // Bytes `text` took in the file, for the omitted-size note
+    static qint64 encoded_size(const QString& text, const QString& encoding);
+
+    static constexpr qint64 kHeadBytes = 16 * 1024;
+    static constexpr qint64 kTailBytes = 4 * 1024;
+    static constexpr int kHeadChars = 1500;
+    static constexpr int kTailChars = 600;
+};
+
+#endif // TEXT_PREVIEW_LOADER_HPP
@@ -0,0 +1,39 @@
+#ifndef VIDEO_THUMBNAILER_HPP
+#define VIDEO_THUMBNAILER_HPP
+
+#include <QString>
+#include <QImage>
+#include <QList>
+#include <functional>
+
+class QProcess;
+
+// Extracts evenly spaced keyframes from a video and composes them into a
+// horizontal filmstrip. Uses Qt Multimedia when built with it, otherwise
+// falls back to ffmpeg/ffprobe if they are on PATH.
+// All calls block — run them on a worker thread, never the GUI thread.
+class VideoThumbnailer {
+public:
+    // Stops between frames, and kills a running ffmpeg, once `cancelled` returns true
+    static QImage extract_filmstrip(const QString& file_path, int frame_count, int frame_height,
+                                    const std::function<bool()>& cancelled = nullptr);
+
+    // True if at least one decoder backend is usable
+    static bool is_available();
+
+private:
+    static QList<QImage> grab_frames_multimedia(const QString& file_path, int frame_count, int frame_height,
+                                                const std::function<bool()>& cancelled);
+    static QList<QImage> grab_frames_ffmpeg(const QString& file_path, int frame_count, int frame_height,
+                                            const std::function<bool()>& cancelled);
+    // Wait for a started process; kills it on timeout or cancel and returns false
+    static bool wait_for(QProcess& process, int timeout_ms, const std::function<bool()>& cancelled);
+    static QImage compose_filmstrip(const QList<QImage>& frames, int frame_height);
+
+    static constexpr int kLoadTimeoutMs = 4000;
+    static constexpr int kFrameTimeoutMs = 2000;
+    static constexpr int kFrameSpacing = 4;
+    static constexpr int kProcessPollMs = 50;
+};
+
+#endif // VIDEO_THUMBNAILER_HPP
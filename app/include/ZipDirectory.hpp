@@ -0,0 +1,52 @@
+#ifndef ZIP_DIRECTORY_HPP
+#define ZIP_DIRECTORY_HPP
+
+#include <QString>
+#include <QByteArray>
+#include <vector>
+
+class QFile;
+
+struct ZipEntry {
+    QString name;
+    quint64 compressed_size = 0;
+    quint64 uncompressed_size = 0;
+    quint64 local_header_offset = 0;
+    quint16 method = 0;       // 0 = stored, 8 = deflate
+    bool is_directory = false;
+};
+
+// Minimal zip reader that parses only the central directory (located from
+// the end-of-central-directory record, Zip64 aware). Opening a multi-GB
+// archive reads a few KB of tail plus the directory itself.
+// Also used for OOXML/ODF containers, which are zip files.
+class ZipDirectory {
+public:
+    // Reads the central directory. Returns false for non-zip or damaged files.
+    bool open(const QString& file_path);
+
+    const std::vector<ZipEntry>& entries() const { return entries_; }
+    quint64 declared_entry_count() const { return declared_entries_; }
+    bool truncated() const { return truncated_; }  // Entry cap reached
+
+    const ZipEntry* find(const QString& name) const;
+
+    // Reads one entry's data. Deflated entries need zlib; returns an empty
+    // array if unsupported or larger than max_size.
+    QByteArray read_entry(const ZipEntry& entry, qint64 max_size) const;
+
+    static bool inflate_supported();
+
+private:
+    bool read_eocd(QFile& file, quint64& cd_offset, quint64& cd_size);
+
+    QString path_;
+    std::vector<ZipEntry> entries_;
+    quint64 declared_entries_ = 0;
+    bool truncated_ = false;
+
+    static constexpr int kMaxEntries = 100000;
+    static constexpr qint64 kMaxDirectoryBytes = 32 * 1024 * 1024;
+};
+
+#endif // ZIP_DIRECTORY_HPP
@@ -56,6 +56,8 @@ namespace ui::dimensions {
     // File preview
     constexpr int kPreviewMaxWidth = 500;
     constexpr int kPreviewMaxHeight = 400;
+    constexpr int kFilmstripFrames = 5;       // Keyframes per video filmstrip
+    constexpr int kFilmstripFrameHeight = 90;
     
     // Main action buttons (2x larger for Keep/Delete)
     constexpr int kMainButtonWidth = 200;
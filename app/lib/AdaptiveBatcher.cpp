@@ -0,0 +1,74 @@
+#include "AdaptiveBatcher.hpp"
+#include <algorithm>
+
+void AdaptiveBatcher::configure(const AiProviderConfig& config, int prompt_overhead_tokens) {
+    // Leave room for the reply inside the context window
+    int window = context_tokens(config);
+    prompt_budget_ = std::max(500, window - kResponseTokens - prompt_overhead_tokens);
+    // A tokens-per-minute limit below the window caps a single request too
+    if (config.rate_limit_tpm > 0) {
+        prompt_budget_ = std::min(prompt_budget_, std::max(500, config.rate_limit_tpm - prompt_overhead_tokens));
+    }
+
+    max_files_ = std::max(kMinBatchFiles, kResponseTokens / kTokensPerAnswer);
+    target_files_ = std::clamp(kInitialBatchFiles, kMinBatchFiles, max_files_);
+    // Small local models lose track of long lists; start lower
+    if (config.is_local) target_files_ = std::max(kMinBatchFiles, target_files_ / 2);
+}
+
+void AdaptiveBatcher::configure(const QList<AiProviderConfig>& pool, int prompt_overhead_tokens) {
+    if (pool.isEmpty()) return;
+    configure(pool.front(), prompt_overhead_tokens);
+    for (int i = 1; i < pool.size(); ++i) {
+        AdaptiveBatcher other;
+        other.configure(pool[i], prompt_overhead_tokens);
+        prompt_budget_ = std::min(prompt_budget_, other.prompt_budget_);
+        target_files_ = std::min(target_files_, other.target_files_);
+    }
+}
+
+QList<int> AdaptiveBatcher::take_batch(std::deque<int>& pending, const std::function<int(int)>& line_tokens) const {
+    QList<int> batch;
+    int tokens = 0;
+    while (!pending.empty() && batch.size() < target_files_) {
+        int cost = line_tokens(pending.front());
+        // Always take at least one file, even if it alone exceeds the budget
+        if (!batch.isEmpty() && tokens + cost > prompt_budget_) break;
+        tokens += cost;
+        batch.append(pending.front());
+        pending.pop_front();
+    }
+    return batch;
+}
+
+void AdaptiveBatcher::record_result(int requested, int parsed, bool truncated) {
+    if (requested <= 0) return;
+    if (truncated || parsed * 2 < requested) {
+        // Multiplicative decrease, sized to what actually came back
+        target_files_ = std::max(kMinBatchFiles, std::min(target_files_ / 2, std::max(parsed, kMinBatchFiles)));
+    } else if (parsed < requested) {
+        target_files_ = std::max(kMinBatchFiles, target_files_ * 3 / 4);
+    } else if (requested >= target_files_) {
+        // Only grow when the batch was actually full-sized
+        target_files_ = std::min(max_files_, target_files_ + std::max(1, target_files_ / 4));
+    }
+}
+
+bool AdaptiveBatcher::looks_truncated(const QString& content) {
+    QString text = content.trimmed();
+    if (text.endsWith("```")) text = text.chopped(3).trimmed();
+    return !text.isEmpty() && !text.endsWith(']');
+}
+
+int AdaptiveBatcher::context_tokens(const AiProviderConfig& config) {
+    const QString model = config.model_name.toLower();
+    if (config.provider_name == "Google Gemini") return 1000000;
+    if (config.provider_name == "Anthropic" || model.contains("claude")) return 200000;
+    if (model.contains("gpt-4o") || model.contains("gpt-4-turbo") || model.contains("gpt-4.1")) return 128000;
+    if (model.contains("gpt-3.5")) return 16000;
+    if (model.contains("llama-3.1") || model.contains("llama-3.3") || model.contains("mistral-large")) return 128000;
+    if (model.contains("mixtral") || model.contains("mistral")) return 32000;
+    // Ollama defaults to a small context unless num_ctx is raised
+    if (config.is_local) return 8192;
+    return 16000;
+}
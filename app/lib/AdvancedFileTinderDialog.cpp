@@ -4,6 +4,7 @@
 #include "FilterWidget.hpp"
 #include "DatabaseManager.hpp"
 #include "FileTinderExecutor.hpp"
+#include "PreviewCache.hpp"
 #include "ui_constants.hpp"
 #include <QKeyEvent>
 #include <QCloseEvent>
@@ -144,6 +145,7 @@ void AdvancedFileTinderDialog::setup_ui() {
             [&excluded](const FileToProcess& f) {
                 return f.is_directory && excluded.contains(f.path);
             }), files_.end());
+        rebuild_search_index();
         rebuild_filtered_indices();
     }
     
@@ -173,6 +175,11 @@ void AdvancedFileTinderDialog::setup_filter_bar() {
     filter_widget_ = new FilterWidget(this);
     connect(filter_widget_, &FilterWidget::filter_changed, this, &AdvancedFileTinderDialog::on_filter_changed);
     connect(filter_widget_, &FilterWidget::sort_changed, this, &AdvancedFileTinderDialog::on_sort_changed);
+    connect(filter_widget_, &FilterWidget::query_changed, this, [this](const QString& text) {
+        QString error;
+        set_filter_query(text, &error);
+        filter_widget_->set_query_error(error);
+    });
     connect(filter_widget_, &FilterWidget::include_folders_changed, this, [this](bool include) {
         include_folders_ = include;
         // Reset counts before re-scanning and reloading state
@@ -543,6 +550,12 @@ void AdvancedFileTinderDialog::setup_action_buttons() {
     connect(reset_btn, &QPushButton::clicked, this, [this]() { on_reset_progress(); });
     bottom_layout->addWidget(reset_btn);
     
+    auto* rules_btn = new QPushButton("Rules");
+    rules_btn->setStyleSheet("QPushButton { padding: 8px 16px; }");
+    rules_btn->setToolTip("Decide many files at once with ordered query rules");
+    connect(rules_btn, &QPushButton::clicked, this, [this]() { show_rules_dialog(); });
+    bottom_layout->addWidget(rules_btn);
+    
     bottom_layout->addStretch();
     
     stats_label_ = new QLabel();
@@ -918,6 +931,9 @@ void AdvancedFileTinderDialog::on_remove_quick_access() {
 }
 
 void AdvancedFileTinderDialog::update_file_info_display() {
+    // Drop directory summaries still running for the previous file
+    preview_generation_->fetch_add(1);
+    
     int idx = get_current_file_index();
     if (idx < 0 || idx >= static_cast<int>(files_.size())) {
         if (adv_file_icon_label_) adv_file_icon_label_->setText("[---]");
@@ -949,6 +965,21 @@ void AdvancedFileTinderDialog::update_file_info_display() {
         .arg(size_str)
         .arg(info.isDir() ? "Folder" : info.suffix().toUpper())
         .arg(info.lastModified().toString("yyyy-MM-dd hh:mm"));
+    
+    // Folder contents are summarized on the preview pool (large trees would freeze the UI)
+    if (info.isDir()) {
+        QString brief;
+        if (PreviewCache::instance().get_text(PreviewCache::make_key(path, "dir-brief"), brief)) {
+            details += " | " + brief;
+        } else {
+            run_preview_job([path]() -> QVariant {
+                return summarize_directory_cached(path, true);
+            }, [this, details](const QVariant& result) {
+                if (file_details_label_) file_details_label_->setText(details + " | " + result.toString());
+            });
+            details += " | scanning...";
+        }
+    }
     if (file_details_label_) file_details_label_->setText(details);
     
     // Small inline image preview (use QImageReader for efficient loading)
@@ -1096,6 +1127,30 @@ void AdvancedFileTinderDialog::on_finish() {
     show_review_summary();
 }
 
+void AdvancedFileTinderDialog::assign_files_to_folder(const QList<int>& indices, const QString& dest) {
+    // Net count change per folder, applied to the model in one go
+    QHash<QString, int> deltas;
+    for (int fi : indices) {
+        if (fi < 0 || fi >= static_cast<int>(files_.size())) continue;
+        const auto& file = files_[fi];
+        if (file.decision == "move" && !file.destination_folder.isEmpty()) deltas[file.destination_folder]--;
+        deltas[dest]++;
+    }
+    StandaloneFileTinderDialog::assign_files_to_folder(indices, dest);
+    if (folder_model_) folder_model_->apply_assignment_deltas(deltas);
+}
+
+void AdvancedFileTinderDialog::on_bulk_moves(const QHash<QString, int>& moves_per_folder) {
+    if (!folder_model_ || moves_per_folder.isEmpty()) return;
+    // Rule destinations may not be on the map yet; undoing a pass only subtracts
+    for (auto it = moves_per_folder.constBegin(); it != moves_per_folder.constEnd(); ++it) {
+        if (it.value() > 0 && !folder_model_->find_node(it.key())) {
+            folder_model_->add_folder(it.key(), !QDir(it.key()).exists());
+        }
+    }
+    folder_model_->apply_assignment_deltas(moves_per_folder);
+}
+
 void AdvancedFileTinderDialog::on_undo() {
     if (undo_stack_.empty()) return;
     
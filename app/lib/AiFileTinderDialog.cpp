@@ -1,4 +1,7 @@
 #include "AiFileTinderDialog.hpp"
+#include "LocalPreClassifier.hpp"
+#include "MockAiProvider.hpp"
+#include "ContentHintExtractor.hpp"
 #include "FolderTreeModel.hpp"
 #include "MindMapView.hpp"
 #include "DatabaseManager.hpp"
@@ -22,19 +25,32 @@
 #include <QScreen>
 #include <QTimer>
 #include <QTextBrowser>
-#include <QEventLoop>
 #include <QElapsedTimer>
 #include <QDateTime>
 #include <QScrollBar>
 #include <QMenu>
 #include <QProgressBar>
 #include <QListView>
-
-// Batch size for API calls
-static const int kBatchSize = 50;
-// Timeout for API requests (ms) — higher for local LLMs
-static const int kCloudTimeoutMs = 60000;
-static const int kLocalTimeoutMs = 120000;
+#include <QListWidget>
+#include <QSet>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentMap>
+#include <memory>
+#include <algorithm>
+
+// Compact prompt encoding: names sharing at least this many leading
+// characters with the previous line are sent as "~N:suffix"
+static const int kMinSharedPrefix = 4;
+// Token estimates for the cost preview, measured on the compact encoding
+static const int kPreambleTokens = 650;
+static const int kTokensPerFolder = 8;
+static const int kPromptTokensPerFile = 14;
+static const int kResponseTokensPerFile = 30;
+// Longest a batch waits for its content hints before going out without them
+static const int kHintBatchBudgetMs = 1500;
 
 // ============================================================
 // AiSetupDialog
@@ -80,6 +96,10 @@ void AiSetupDialog::build_ui() {
     provider_combo_->addItems({"OpenAI", "Anthropic", "Google Gemini", "Mistral",
                                "Groq", "OpenRouter", "Ollama (Local)", "LM Studio (Local)",
                                "Custom"});
+    // Offline mock server for benchmarking; opt-in via settings
+    if (QSettings("FileTinder", "FileTinder").value("mockAi/enabled", false).toBool()) {
+        provider_combo_->addItem(MockAiProvider::kProviderName);
+    }
     QStringList saved = db_.get_ai_provider_names();
     for (const QString& name : saved) {
         if (provider_combo_->findText(name) < 0)
@@ -126,6 +146,23 @@ void AiSetupDialog::build_ui() {
     model_row->addWidget(fetch_btn);
     prov_layout->addLayout(model_row);
 
+    // Other saved providers can share the load and take over on failure
+    fallback_list_ = new QListWidget();
+    fallback_list_->setMaximumHeight(ui::scaling::scaled(60));
+    fallback_list_->setToolTip("Checked providers take part of the batches and take over when the main one fails");
+    QStringList checked_fallbacks = QSettings("FileTinder", "FileTinder").value("ai/fallbackProviders").toStringList();
+    for (const QString& name : db_.get_ai_provider_names()) {
+        auto* item = new QListWidgetItem(name, fallback_list_);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(checked_fallbacks.contains(name) ? Qt::Checked : Qt::Unchecked);
+    }
+    if (fallback_list_->count() > 0) {
+        prov_layout->addWidget(new QLabel("Also use (saved providers):"));
+        prov_layout->addWidget(fallback_list_);
+    } else {
+        fallback_list_->hide();
+    }
+
     // Recalculate cost when model name changes (free models suppress warning)
     connect(model_combo_, &QComboBox::currentTextChanged, this, [this]() { update_cost_estimate(); });
 
@@ -171,6 +208,11 @@ void AiSetupDialog::build_ui() {
             model_combo_->addItems({"llama3.1", "llama3", "mistral", "gemma2"});
             model_combo_->setCurrentText("llama3.1");
             api_key_edit_->clear();
+        } else if (text == MockAiProvider::kProviderName) {
+            endpoint_edit_->setText(MockAiProvider::instance().ensure_started() + "/v1/chat/completions");
+            model_combo_->addItem("mock-model");
+            model_combo_->setCurrentText("mock-model");
+            api_key_edit_->clear();
         } else if (text.contains("LM Studio")) {
             endpoint_edit_->setText("http://localhost:1234/v1/chat/completions");
             model_combo_->addItem("local-model");
@@ -329,6 +371,12 @@ void AiSetupDialog::save_provider_config() {
                          endpoint_edit_->text().trimmed(),
                          model_combo_->currentText().trimmed(),
                          is_local, default_rate_limit(provider));
+
+    QStringList fallbacks;
+    for (int i = 0; i < fallback_list_->count(); ++i) {
+        if (fallback_list_->item(i)->checkState() == Qt::Checked) fallbacks << fallback_list_->item(i)->text();
+    }
+    QSettings("FileTinder", "FileTinder").setValue("ai/fallbackProviders", fallbacks);
 }
 
 void AiSetupDialog::update_cost_estimate() {
@@ -359,9 +407,23 @@ void AiSetupDialog::update_cost_estimate() {
     else if (model.contains("mistral-small")) { input_price = 0.20; output_price = 0.60; }
     else if (model.contains("mistral-large")) { input_price = 2.0; output_price = 6.0; }
 
-    int batches = (file_count_ + kBatchSize - 1) / kBatchSize;
-    double input_tokens = file_count_ * 200.0 + batches * 500.0;
-    double output_tokens = file_count_ * 80.0;
+    int batches = (file_count_ + AdaptiveBatcher::kInitialBatchFiles - 1) / AdaptiveBatcher::kInitialBatchFiles;
+    // The instructions and folder table repeat in every batch, but providers
+    // with prompt caching bill the repeats at a discount (Anthropic: 1.25x to
+    // write, 0.1x to read; OpenAI: 0.5x for cached prefixes) once the prefix
+    // is long enough to be cached at all
+    double preamble = kPreambleTokens + existing_folders_.size() * static_cast<double>(kTokensPerFolder);
+    double write_factor = 1.0, read_factor = 1.0;
+    if (preamble >= AiRequestDispatcher::min_cacheable_tokens(provider, model)) {
+        if (provider == "Anthropic") { write_factor = 1.25; read_factor = 0.1; }
+        else if (provider == "OpenAI") { read_factor = 0.5; }
+    }
+    // The first wave of parallel requests goes out before any has written
+    // the cache, so each of them pays full (or write) price
+    int misses = std::min(batches, default_concurrency(provider));
+    double input_tokens = file_count_ * static_cast<double>(kPromptTokensPerFile);
+    input_tokens += misses * preamble * write_factor + (batches - misses) * preamble * read_factor;
+    double output_tokens = file_count_ * static_cast<double>(kResponseTokensPerFile);
     double cost = (input_tokens * input_price + output_tokens * output_price) / 1000000.0;
     
     cost_label_->setStyleSheet("color: #f39c12; font-size: 11px;");
@@ -386,6 +448,26 @@ int AiSetupDialog::default_rate_limit(const QString& provider) const {
     return 60;
 }
 
+int AiSetupDialog::default_token_limit(const QString& provider) const {
+    // Entry-tier input token budgets; 0 = no token limit enforced locally
+    if (provider == "OpenAI") return 200000;
+    if (provider == "Anthropic") return 50000;
+    if (provider == "Google Gemini") return 1000000;
+    if (provider == "Mistral") return 500000;
+    if (provider == "Groq") return 6000;
+    return 0;
+}
+
+int AiSetupDialog::default_concurrency(const QString& provider) const {
+    if (provider == MockAiProvider::kProviderName) return 4;
+    // Local servers mostly process one prompt at a time; extra in-flight
+    // requests just queue there, but keep the GPU busy between batches
+    if (provider.contains("Ollama") || provider.contains("LM Studio") || provider.contains("Local"))
+        return 2;
+    if (provider == "Groq" || provider == "OpenRouter") return 2;
+    return 4;
+}
+
 void AiSetupDialog::fetch_models(const QString& provider) {
     QString api_key = api_key_edit_->text().trimmed();
     QString endpoint = endpoint_edit_->text().trimmed();
@@ -516,18 +598,40 @@ QString AiSetupDialog::folder_purpose() const {
     return purpose_edit_->toPlainText().trimmed();
 }
 
-AiProviderConfig AiSetupDialog::provider_config() const {
+AiProviderConfig AiSetupDialog::make_provider_config(const QString& provider, const QString& api_key,
+                                                     const QString& endpoint, const QString& model) const {
     AiProviderConfig cfg;
-    cfg.provider_name = provider_combo_->currentText();
-    cfg.api_key = api_key_edit_->text().trimmed();
-    cfg.endpoint_url = endpoint_edit_->text().trimmed();
-    cfg.model_name = model_combo_->currentText().trimmed();
+    cfg.provider_name = provider;
+    cfg.api_key = api_key;
+    cfg.endpoint_url = endpoint;
+    cfg.model_name = model;
     cfg.is_local = cfg.provider_name.contains("Ollama") || cfg.provider_name.contains("LM Studio")
                    || cfg.provider_name.contains("Local");
     cfg.rate_limit_rpm = default_rate_limit(cfg.provider_name);
+    cfg.rate_limit_tpm = default_token_limit(cfg.provider_name);
+    cfg.max_concurrent = default_concurrency(cfg.provider_name);
     return cfg;
 }
 
+AiProviderConfig AiSetupDialog::provider_config() const {
+    return make_provider_config(provider_combo_->currentText(), api_key_edit_->text().trimmed(),
+                                endpoint_edit_->text().trimmed(), model_combo_->currentText().trimmed());
+}
+
+QList<AiProviderConfig> AiSetupDialog::provider_pool() const {
+    QList<AiProviderConfig> pool{provider_config()};
+    for (int i = 0; i < fallback_list_->count(); ++i) {
+        QListWidgetItem* item = fallback_list_->item(i);
+        if (item->checkState() != Qt::Checked || item->text() == pool.front().provider_name) continue;
+        QString api_key, endpoint, model;
+        bool is_local = false;
+        int rpm = 60;
+        if (!db_.get_ai_provider(item->text(), api_key, endpoint, model, is_local, rpm)) continue;
+        pool.append(make_provider_config(item->text(), api_key, endpoint, model));
+    }
+    return pool;
+}
+
 int AiSetupDialog::confidence_threshold() const {
     return confidence_spin_->value();
 }
@@ -544,14 +648,25 @@ AiFileTinderDialog::AiFileTinderDialog(const QString& source_folder,
     , category_mode_(AiCategoryMode::KeepExisting)
     , semi_count_(3)
     , category_depth_(2)
-    , network_manager_(new QNetworkAccessManager(this))
-    , rate_limit_timer_(new QTimer(this))
-    , requests_this_minute_(0) {
+    , dispatcher_(new AiRequestDispatcher(this)) {
 
     setWindowTitle(QString("File Tinder - AI Mode \xe2\x80\x94 %1").arg(QFileInfo(source_folder).fileName()));
 
-    rate_limit_timer_->setInterval(60000);
-    connect(rate_limit_timer_, &QTimer::timeout, this, &AiFileTinderDialog::reset_rate_limit);
+    connect(dispatcher_, &AiRequestDispatcher::request_finished,
+            this, &AiFileTinderDialog::on_analysis_batch_finished);
+    connect(dispatcher_, &AiRequestDispatcher::request_failed,
+            this, &AiFileTinderDialog::on_analysis_batch_failed);
+    connect(dispatcher_, &AiRequestDispatcher::object_received,
+            this, &AiFileTinderDialog::on_analysis_object_received);
+    connect(dispatcher_, &AiRequestDispatcher::all_done, this, [this]() {
+        if (analysis_pending_.empty() && active_batches_.isEmpty() && analysis_preparing_ == 0) complete_ai_analysis();
+    });
+    connect(dispatcher_, &AiRequestDispatcher::throttled, this, [this](const QString& reason, int wait_ms) {
+        log_analysis(QString("%1: waiting %2s...").arg(reason).arg(wait_ms / 1000.0, 0, 'f', 1));
+    });
+    connect(dispatcher_, &AiRequestDispatcher::provider_failed_over, this, [this](const QString& provider, const QString& error) {
+        log_analysis(QString("%1 failed, moving its work to the other providers: %2").arg(provider, error.left(120)));
+    });
 }
 
 AiFileTinderDialog::~AiFileTinderDialog() = default;
@@ -738,7 +853,7 @@ bool AiFileTinderDialog::show_ai_setup() {
     category_mode_ = setup.category_mode();
     category_depth_ = setup.category_depth();
     folder_purpose_ = setup.folder_purpose();
-    provider_config_ = setup.provider_config();
+    provider_pool_ = setup.provider_pool();
     confidence_threshold_ = setup.confidence_threshold();
 
     // Validate: KeepExisting with empty grid is incompatible
@@ -754,13 +869,26 @@ bool AiFileTinderDialog::show_ai_setup() {
         category_mode_ = AiCategoryMode::GenerateNew;
     }
 
-    // Detect free-tier usage for smart rate handling
-    is_free_tier_ = provider_config_.model_name.contains("free", Qt::CaseInsensitive)
-                    || provider_config_.model_name.contains(":free")
-                    || provider_config_.provider_name == "Groq";
-    consecutive_429s_ = 0;
-
-    rate_limit_timer_->start();
+    for (AiProviderConfig& config : provider_pool_) {
+        // Detect free-tier usage for smart rate handling
+        config.is_free_tier = config.model_name.contains("free", Qt::CaseInsensitive)
+                              || config.model_name.contains(":free")
+                              || config.provider_name == "Groq";
+
+        // The mock listens on a fresh port each run, so never trust a saved endpoint
+        if (config.provider_name == MockAiProvider::kProviderName) {
+            MockAiProvider::instance().set_options(MockAiOptions::from_settings());
+            QString base_url = MockAiProvider::instance().ensure_started();
+            if (base_url.isEmpty()) {
+                QMessageBox::warning(this, "Mock Provider", "Could not start the local mock AI server.");
+                return false;
+            }
+            config.endpoint_url = base_url + "/v1/chat/completions";
+        }
+    }
+    provider_config_ = provider_pool_.front();
+    // Record mode: successful replies are appended for later replay by the mock
+    dispatcher_->set_record_path(QSettings("FileTinder", "FileTinder").value("mockAi/recordPath").toString());
     return true;
 }
 
@@ -769,6 +897,7 @@ void AiFileTinderDialog::run_ai_analysis(bool remaining_only) {
         QMessageBox::information(this, "No Files", "No files to analyze.");
         return;
     }
+    if (analysis_running_) return;
 
     // When overwriting all decisions, reset existing ones first
     if (!remaining_only) {
@@ -797,68 +926,79 @@ void AiFileTinderDialog::run_ai_analysis(bool remaining_only) {
         return;
     }
 
-    // Build file descriptions
-    QStringList file_descriptions;
-    for (int idx : file_indices) {
-        const auto& f = files_[idx];
-        file_descriptions.append(QString("%1|%2|%3|%4|%5")
-            .arg(idx).arg(f.name).arg(f.extension).arg(f.size).arg(f.mime_type));
-    }
-
     // Build available folders list
-    QStringList available_folders;
+    analysis_folders_.clear();
     if (folder_model_) {
-        available_folders = folder_model_->get_all_folder_paths();
+        analysis_folders_ = folder_model_->get_all_folder_paths();
     }
-    if (!available_folders.contains(source_folder_)) {
-        available_folders.prepend(source_folder_);
+    if (!analysis_folders_.contains(source_folder_)) {
+        analysis_folders_.prepend(source_folder_);
     }
 
-    // Calculate batches
-    int total_files = static_cast<int>(file_descriptions.size());
-    int total_batches = (total_files + kBatchSize - 1) / kBatchSize;
-
-    // Progress dialog with real-time log
-    QDialog progress_dialog(this);
-    progress_dialog.setWindowTitle("AI Analysis");
-    progress_dialog.setMinimumSize(ui::scaling::scaled(550), ui::scaling::scaled(400));
-    auto* prog_layout = new QVBoxLayout(&progress_dialog);
-
-    auto* prog_header = new QLabel(QString("Analyzing %1 files...").arg(total_files));
+    analysis_total_ = static_cast<int>(file_indices.size());
+    analysis_done_ = 0;
+    analysis_classified_ = 0;
+    analysis_stopped_ = false;
+    consecutive_batch_failures_ = 0;
+    active_batches_.clear();
+    // Non-modal progress window; sorting continues while batches run
+    auto* progress_window = new QDialog(this);
+    progress_window->setAttribute(Qt::WA_DeleteOnClose);
+    progress_window->setModal(false);
+    progress_window->setWindowTitle("AI Analysis");
+    progress_window->setMinimumSize(ui::scaling::scaled(550), ui::scaling::scaled(400));
+    auto* prog_layout = new QVBoxLayout(progress_window);
+
+    auto* prog_header = new QLabel(QString("Analyzing %1 files... You can keep sorting meanwhile.").arg(analysis_total_));
     prog_header->setStyleSheet("font-size: 14px; font-weight: bold; color: #3498db;");
     prog_layout->addWidget(prog_header);
 
     auto* prog_bar = new QProgressBar();
-    prog_bar->setRange(0, total_batches);
+    prog_bar->setRange(0, analysis_total_);
     prog_bar->setValue(0);
     prog_layout->addWidget(prog_bar);
+    analysis_progress_ = prog_bar;
 
     auto* log_browser = new QTextBrowser();
     log_browser->setStyleSheet("QTextBrowser { background: #1a1a2e; color: #e0e0e0; font-family: monospace; font-size: 11px; }");
     log_browser->setReadOnly(true);
     prog_layout->addWidget(log_browser, 1);
-
+    analysis_log_ = log_browser;
+
+    auto* prog_btns = new QHBoxLayout();
+    prog_btns->addStretch();
+    auto* hide_btn = new QPushButton("Hide");
+    hide_btn->setToolTip("Close this window; analysis continues in the background");
+    hide_btn->setStyleSheet("QPushButton { padding: 6px 16px; }");
+    connect(hide_btn, &QPushButton::clicked, progress_window, &QDialog::close);
+    prog_btns->addWidget(hide_btn);
     auto* cancel_btn = new QPushButton("Cancel");
     cancel_btn->setStyleSheet("QPushButton { padding: 6px 16px; }");
-    prog_layout->addWidget(cancel_btn, 0, Qt::AlignRight);
-
-    bool cancelled = false;
-    connect(cancel_btn, &QPushButton::clicked, this, [&cancelled]() { cancelled = true; });
-
-    progress_dialog.show();
-    QApplication::processEvents();
-
-    auto log = [&](const QString& msg) {
-        QString ts = QDateTime::currentDateTime().toString("hh:mm:ss");
-        log_browser->append(QString("[%1] %2").arg(ts, msg));
-        log_browser->verticalScrollBar()->setValue(log_browser->verticalScrollBar()->maximum());
-        QApplication::processEvents();
-    };
-
-    log(QString("Starting AI analysis of %1 files...").arg(total_files));
-    log(QString("Provider: %1 (%2) | Rate: %3 req/min")
-        .arg(provider_config_.provider_name, provider_config_.model_name)
-        .arg(provider_config_.rate_limit_rpm));
+    connect(cancel_btn, &QPushButton::clicked, this, [this]() {
+        if (!analysis_running_) return;
+        analysis_stopped_ = true;
+        dispatcher_->cancel_all();
+        log_analysis("Cancelled by user");
+        complete_ai_analysis();
+    });
+    prog_btns->addWidget(cancel_btn);
+    prog_layout->addLayout(prog_btns);
+    analysis_window_ = progress_window;
+
+    analysis_running_ = true;
+    analysis_timer_.start();
+    if (ai_setup_btn_) ai_setup_btn_->setEnabled(false);
+    if (rerun_ai_btn_) rerun_ai_btn_->setEnabled(false);
+    progress_window->show();
+
+    log_analysis(QString("Starting AI analysis of %1 files...").arg(analysis_total_));
+    for (const AiProviderConfig& config : provider_pool_) {
+        log_analysis(QString("%1: %2 (%3) | Rate: %4 req/min | Up to %5 requests in flight")
+            .arg(&config == &provider_pool_.front() ? "Provider" : "Fallback")
+            .arg(config.provider_name, config.model_name)
+            .arg(config.rate_limit_rpm)
+            .arg(config.is_free_tier ? 1 : config.max_concurrent));
+    }
 
     QString cat_mode_name;
     switch (category_mode_) {
@@ -867,7 +1007,7 @@ void AiFileTinderDialog::run_ai_analysis(bool remaining_only) {
         case AiCategoryMode::SynthesizeNew: cat_mode_name = "Synthesize new"; break;
         case AiCategoryMode::KeepPlusGenerate: cat_mode_name = "Keep + Generate"; break;
     }
-    log(QString("Category mode: %1 | Depth: %2").arg(cat_mode_name).arg(category_depth_));
+    log_analysis(QString("Category mode: %1 | Depth: %2").arg(cat_mode_name).arg(category_depth_));
 
     // Clear previous suggestions for files we're re-analyzing
     if (remaining_only) {
@@ -884,236 +1024,570 @@ void AiFileTinderDialog::run_ai_analysis(bool remaining_only) {
         suggestions_.clear();
     }
 
-    QElapsedTimer elapsed;
-    elapsed.start();
-    int files_classified = 0;
+    // Serve unchanged files from the classification cache
+    analysis_cache_key_ = classification_config_key();
+    db_.prune_ai_classifications();
+    int cache_hits = take_cached_classifications(file_indices);
+    analysis_classified_ += cache_hits;
+    analysis_done_ += cache_hits;
+    update_analysis_progress();
+    log_analysis(QString("Cache: %1/%2 files served locally (%3%), %4 sent to provider")
+        .arg(cache_hits).arg(analysis_total_)
+        .arg(analysis_total_ > 0 ? cache_hits * 100 / analysis_total_ : 0)
+        .arg(static_cast<int>(file_indices.size())));
+
+    // Files whose names clearly match past decisions never reach the provider
+    int local_hits = take_local_classifications(file_indices);
+    if (local_hits > 0) {
+        analysis_classified_ += local_hits;
+        analysis_done_ += local_hits;
+        update_analysis_progress();
+        log_analysis(QString("Pre-classifier: %1 files assigned from past decisions, %2 left for the provider")
+            .arg(local_hits).arg(static_cast<int>(file_indices.size())));
+    }
 
-    for (int batch = 0; batch < total_batches && !cancelled; ++batch) {
-        int start = batch * kBatchSize;
-        int end = qMin(start + kBatchSize, total_files);
-        int batch_size = end - start;
+    // Batches are cut as earlier ones come back, so their size can adapt;
+    // the dispatcher paces them against the rate budget
+    dispatcher_->configure(provider_pool_);
+    analysis_preamble_ = build_analysis_preamble(analysis_folders_);
+    int prompt_overhead = AiRequestDispatcher::estimate_tokens(analysis_preamble_);
+    batcher_.configure(provider_pool_, prompt_overhead);
+    // Classify in the order the user will meet the files, from where they are now
+    analysis_pending_.assign(file_indices.begin(), file_indices.end());
+    prioritized_at_ = -1;
+    prioritize_pending();
+    log_analysis(QString("Batch size: starting at %1 files (max %2)")
+        .arg(batcher_.target_files()).arg(batcher_.max_files()));
+    fill_analysis_queue();
+
+    // Cached and local results are usable straight away in semi mode
+    if (sort_mode_ == AiSortMode::Semi) show_current_file();
+    // Everything may already have come from the cache
+    if (analysis_pending_.empty() && analysis_preparing_ == 0 && dispatcher_->is_idle()) complete_ai_analysis();
+}
 
-        log(QString("Batch %1/%2 \xe2\x80\x94 analyzing files %3-%4...")
-            .arg(batch + 1).arg(total_batches).arg(start + 1).arg(end));
+void AiFileTinderDialog::complete_ai_analysis() {
+    if (!analysis_running_) return;
+    analysis_running_ = false;
+    ++analysis_generation_;   // Batches still extracting hints are dropped
+    analysis_preparing_ = 0;
+    active_batches_.clear();
+    analysis_pending_.clear();
+    if (ai_setup_btn_) {
+        ai_setup_btn_->setEnabled(true);
+        ai_setup_btn_->setText("AI Setup");
+    }
+    // Enable re-run button after first analysis
+    if (rerun_ai_btn_) rerun_ai_btn_->setEnabled(true);
 
-        // Build batch file list
-        QStringList batch_files;
-        for (int i = start; i < end; ++i) {
-            batch_files.append(file_descriptions[i]);
-        }
+    log_analysis(QString("Analysis complete -- %1 files classified (%2s)")
+        .arg(analysis_classified_).arg(analysis_timer_.elapsed() / 1000.0, 0, 'f', 1));
+    log_provider_stats();
 
-        // Smart rate limiting: enforce per-request delay and per-minute cap
-        if (!check_rate_limit()) {
-            int wait_secs = 60 - (elapsed.elapsed() / 1000) % 60;
-            if (wait_secs <= 0) wait_secs = 5;
-            log(QString("Rate limit reached: waiting %1s...").arg(wait_secs));
-            QEventLoop wait_loop;
-            QTimer::singleShot(wait_secs * 1000, &wait_loop, &QEventLoop::quit);
-            wait_loop.exec();
-            reset_rate_limit();
-        } else if (batch > 0) {
-            // Smart pacing: add delay between requests for free/strict APIs
-            int delay_ms = 0;
-            if (provider_config_.is_local) {
-                delay_ms = 0;
-            } else if (is_free_tier_) {
-                delay_ms = 3000 + consecutive_429s_ * 2000;  // 3s base + backoff
-            } else if (provider_config_.rate_limit_rpm <= 30) {
-                delay_ms = 2500;  // conservative for strict limits
-            } else if (provider_config_.rate_limit_rpm <= 60) {
-                delay_ms = 1200;
-            } else {
-                delay_ms = 500;   // light pacing for generous limits
-            }
-            if (delay_ms > 0) {
-                log(QString("Pacing: %1ms delay...").arg(delay_ms));
-                QEventLoop pace_loop;
-                QTimer::singleShot(delay_ms, &pace_loop, &QEventLoop::quit);
-                pace_loop.exec();
-            }
-        }
+    finish_ai_analysis();
 
-        // Build prompt for this batch
-        QString prompt = build_analysis_prompt(batch_files, available_folders);
+    // Leave the completion message up for a moment
+    if (analysis_window_) QTimer::singleShot(1500, analysis_window_.data(), &QDialog::close);
 
-        // Send request
-        QElapsedTimer batch_timer;
-        batch_timer.start();
+    // Apply results based on mode
+    if (sort_mode_ == AiSortMode::Auto) {
+        apply_auto_suggestions();
+    } else {
+        apply_semi_suggestions();
+    }
+}
+
+void AiFileTinderDialog::update_analysis_progress() {
+    if (analysis_progress_) analysis_progress_->setValue(analysis_done_);
+    if (ai_setup_btn_ && analysis_running_ && analysis_total_ > 0) {
+        ai_setup_btn_->setText(QString("AI %1%").arg(analysis_done_ * 100 / analysis_total_));
+    }
+}
 
-        QString error;
-        QString response = send_api_request(prompt, error);
+void AiFileTinderDialog::prioritize_pending() {
+    if (analysis_pending_.empty()) return;
+    const int n = static_cast<int>(filtered_indices_.size());
+    const int current = current_filtered_index_;
+
+    // The queue is still laid out for this filtered order if the head sits
+    // where it was when sorted (hidden files have no position)
+    int head = analysis_pending_.front();
+    auto head_pos = pending_position_.constFind(head);
+    bool same_order = prioritized_at_ >= 0 && n == prioritized_count_ &&
+        (head_pos == pending_position_.constEnd() || (*head_pos < n && filtered_indices_[*head_pos] == head));
+
+    if (same_order && current >= prioritized_at_) {
+        // Swiping forward: only files the user has just passed are out of
+        // place, and they are at the head. Move them behind the rest.
+        while (!analysis_pending_.empty()) {
+            auto pos = pending_position_.constFind(analysis_pending_.front());
+            if (pos == pending_position_.constEnd() || *pos < prioritized_at_ || *pos >= current) break;
+            analysis_pending_.push_back(analysis_pending_.front());
+            analysis_pending_.pop_front();
+        }
+        prioritized_at_ = current;
+        return;
+    }
 
-        if (!error.isEmpty()) {
-            log(QString("ERROR: Batch %1/%2 failed: %3").arg(batch + 1).arg(total_batches).arg(error));
+    // Full sort after a jump back or a filter change: distance ahead of the
+    // current position in the filtered order; files behind wrap around,
+    // files hidden by the filter go last
+    pending_position_.clear();
+    pending_position_.reserve(n);
+    for (int pos = 0; pos < n; ++pos) pending_position_.insert(filtered_indices_[pos], pos);
+    auto rank = [this, n, current](int file_idx) {
+        auto pos = pending_position_.constFind(file_idx);
+        return pos == pending_position_.constEnd() ? n : ((*pos - current) % n + n) % n;
+    };
+    std::stable_sort(analysis_pending_.begin(), analysis_pending_.end(), [&rank](int a, int b) {
+        return rank(a) < rank(b);
+    });
+    prioritized_at_ = current;
+    prioritized_count_ = n;
+}
 
-            // Error recovery: let user choose
-            progress_dialog.hide();
-            auto reply = QMessageBox::question(this, "AI Analysis Interrupted",
-                QString("AI analysis interrupted after %1/%2 files.\n\n"
-                        "%3 files remain unclassified.\n\n"
-                        "What would you like to do?")
-                    .arg(files_classified).arg(total_files).arg(total_files - files_classified),
-                QMessageBox::Abort | QMessageBox::Ignore,
-                QMessageBox::Ignore);
+void AiFileTinderDialog::fill_analysis_queue() {
+    // Keep just enough batches queued to saturate the allowed concurrency
+    int slots = dispatcher_->max_concurrency();
+    while (!analysis_stopped_ && !analysis_pending_.empty()
+           && dispatcher_->queued_count() + dispatcher_->in_flight_count() + analysis_preparing_ < slots) {
+        // Files are taken in order, so each line compresses against the last
+        QString previous;
+        QList<int> batch = batcher_.take_batch(analysis_pending_, [this, &previous](int idx) {
+            int tokens = AiRequestDispatcher::estimate_tokens(describe_file(idx, previous)) + 1;
+            previous = files_[idx].name;
+            return tokens;
+        });
+        if (batch.isEmpty()) break;
+        prepare_analysis_batch(batch);
+    }
+}
 
-            if (reply == QMessageBox::Abort) {
-                suggestions_.clear();
-                return;
-            }
-            // Continue to review with partial results
-            break;
+void AiFileTinderDialog::prepare_analysis_batch(const QList<int>& file_indices) {
+    // Content hints are extracted in parallel on the global pool; files
+    // seen in an earlier run or batch reuse theirs
+    QList<QPair<int, QPair<QString, QString>>> todo;
+    for (int idx : file_indices) {
+        if (!content_hints_.contains(idx) && !files_[idx].is_directory) {
+            todo.append({idx, {files_[idx].path, files_[idx].mime_type}});
         }
+    }
+    if (todo.isEmpty()) {
+        submit_analysis_batch(file_indices, false);
+        return;
+    }
 
-        double batch_secs = batch_timer.elapsed() / 1000.0;
+    ++analysis_preparing_;
+    int generation = analysis_generation_;
+    auto submitted = std::make_shared<bool>(false);
+    auto submit = [this, file_indices, generation, submitted]() {
+        if (*submitted) return;
+        *submitted = true;
+        if (generation != analysis_generation_) return;
+        --analysis_preparing_;
+        if (!analysis_running_ || analysis_stopped_) return;
+        submit_analysis_batch(file_indices, false);
+        fill_analysis_queue();
+    };
 
-        // Parse response
-        auto batch_suggestions = parse_ai_response(response);
-        int parsed_count = static_cast<int>(batch_suggestions.size());
-        files_classified += parsed_count;
+    using HintJob = QPair<int, QPair<QString, QString>>;
+    auto* watcher = new QFutureWatcher<QPair<int, QString>>(this);
+    connect(watcher, &QFutureWatcher<QPair<int, QString>>::finished, this, [this, watcher, submit]() {
+        if (!watcher->isCanceled()) {
+            for (const auto& result : watcher->future().results()) content_hints_.insert(result.first, result.second);
+        }
+        watcher->deleteLater();
+        submit();
+    });
+    watcher->setFuture(QtConcurrent::mapped(todo, [](const HintJob& job) {
+        return qMakePair(job.first, ContentHintExtractor::extract(job.second.first, job.second.second));
+    }));
+    // Slow disks must not stall the queue: send without hints after the budget
+    QPointer<QFutureWatcher<QPair<int, QString>>> guard(watcher);
+    QTimer::singleShot(kHintBatchBudgetMs, this, [guard, submit]() {
+        if (guard && !guard->isFinished()) LOG_DEBUG("AIMode", "Content hints over budget; sending batch without them");
+        submit();
+    });
+}
 
-        // If partial parse failure, retry once
-        if (parsed_count < batch_size) {
-            int failed = batch_size - parsed_count;
-            log(QString("%1/%2 files parsed. Retrying %3 failed...")
-                .arg(parsed_count).arg(batch_size).arg(failed));
+void AiFileTinderDialog::submit_analysis_batch(const QList<int>& file_indices, bool is_retry) {
+    QString prompt = build_batch_prompt(file_indices);
+    if (is_retry) {
+        prompt += "\nIMPORTANT: Return ONLY valid JSON. No extra text.\n";
+    }
 
-            // Build a retry prompt with just the failed file indices
-            QSet<int> parsed_indices;
-            for (const auto& s : batch_suggestions) parsed_indices.insert(s.file_index);
+    AnalysisBatch batch;
+    batch.file_indices = file_indices;
+    batch.is_retry = is_retry;
+    int request_id = dispatcher_->submit(prompt,
+        AiRequestDispatcher::estimate_tokens(analysis_preamble_) + AiRequestDispatcher::estimate_tokens(prompt),
+        analysis_preamble_);
+    active_batches_.insert(request_id, batch);
+}
 
-            QStringList retry_files;
-            for (int i = start; i < end; ++i) {
-                int orig_idx = file_descriptions[i].split('|').first().toInt();
-                if (!parsed_indices.contains(orig_idx)) {
-                    retry_files.append(file_descriptions[i]);
-                }
-            }
+bool AiFileTinderDialog::accept_batch_suggestion(AnalysisBatch& batch, const AiFileSuggestion& suggestion) {
+    // Only accept suggestions for files that were actually in this batch
+    if (suggestion.file_index < 0 || suggestion.suggested_folders.isEmpty()) return false;
+    if (!batch.file_indices.contains(suggestion.file_index) || batch.received.contains(suggestion.file_index))
+        return false;
+    batch.received.insert(suggestion.file_index);
+    batch.to_cache.insert(classification_fingerprint(suggestion.file_index), suggestion_to_json(suggestion));
+    suggestions_.push_back(suggestion);
+    ++analysis_classified_;
+    ++analysis_done_;
+    return true;
+}
 
-            if (!retry_files.isEmpty()) {
-                QString retry_prompt = build_analysis_prompt(retry_files, available_folders);
-                retry_prompt += "\nIMPORTANT: Return ONLY valid JSON. No extra text.\n";
-                QString retry_error;
-                QString retry_response = send_api_request(retry_prompt, retry_error);
-                if (retry_error.isEmpty()) {
-                    auto retry_results = parse_ai_response(retry_response);
-                    for (auto& s : retry_results) {
-                        batch_suggestions.push_back(s);
-                    }
-                    files_classified += static_cast<int>(retry_results.size());
-                    log(QString("  Retry recovered %1 more files").arg(retry_results.size()));
-                }
+void AiFileTinderDialog::on_analysis_object_received(int request_id, const QJsonObject& object, int provider) {
+    auto it = active_batches_.find(request_id);
+    if (it == active_batches_.end()) return;
+    if (provider != 0) it->from_fallback = true;
+    AiFileSuggestion suggestion = parse_suggestion_object(object);
+    if (!accept_batch_suggestion(it.value(), suggestion)) return;
+
+    update_analysis_progress();
+    // Semi mode: light up the folders for the file on screen right away
+    if (sort_mode_ == AiSortMode::Semi && suggestion.file_index == get_current_file_index()) {
+        show_current_file();
+    }
+}
+
+void AiFileTinderDialog::on_analysis_batch_finished(int request_id, const QString& content, qint64 elapsed_ms, int provider) {
+    if (!active_batches_.contains(request_id)) return;
+    AnalysisBatch batch = active_batches_.take(request_id);
+    if (provider != 0) batch.from_fallback = true;
+    consecutive_batch_failures_ = 0;
+    int batch_size = static_cast<int>(batch.file_indices.size());
+
+    // Streamed objects are already in; the full parse only fills gaps
+    int streamed_count = static_cast<int>(batch.received.size());
+    int current_file = get_current_file_index();
+    bool had_current = batch.received.contains(current_file);
+    for (const auto& s : parse_ai_response(content)) {
+        accept_batch_suggestion(batch, s);
+    }
+    if (sort_mode_ == AiSortMode::Semi && !had_current && batch.received.contains(current_file)) {
+        show_current_file();
+    }
+    save_batch_to_cache(batch);
+    const QSet<int>& parsed_indices = batch.received;
+    int parsed_count = static_cast<int>(parsed_indices.size());
+    if (streamed_count > 0) {
+        LOG_DEBUG("AIMode", QString("Batch %1: %2 of %3 suggestions arrived while streaming")
+            .arg(request_id).arg(streamed_count).arg(parsed_count));
+    }
+
+    log_analysis(QString("%1 complete \xe2\x80\x94 %2/%3 files parsed (%4s) | %5/%6 classified")
+        .arg(batch.is_retry ? "Retry batch" : "Batch")
+        .arg(parsed_count).arg(batch_size)
+        .arg(elapsed_ms / 1000.0, 0, 'f', 1)
+        .arg(analysis_classified_).arg(analysis_total_));
+
+    // Resize future batches from how well this one came back
+    bool truncated = AdaptiveBatcher::looks_truncated(content);
+    int previous_target = batcher_.target_files();
+    batcher_.record_result(batch_size, parsed_count, truncated);
+    if (batcher_.target_files() != previous_target) {
+        log_analysis(QString("  Batch size %1 -> %2 files%3")
+            .arg(previous_target).arg(batcher_.target_files())
+            .arg(truncated ? " (response truncated)" : ""));
+    }
+
+    // Partial parse: retry only the missing files once, at the new size
+    QList<int> missing;
+    for (int idx : batch.file_indices) {
+        if (!parsed_indices.contains(idx)) missing.append(idx);
+    }
+    if (!missing.isEmpty()) {
+        if (!batch.is_retry && !analysis_stopped_) {
+            log_analysis(QString("  Retrying %1 unparsed files...").arg(missing.size()));
+            int chunk = batcher_.target_files();
+            for (int start = 0; start < missing.size(); start += chunk) {
+                submit_analysis_batch(missing.mid(start, chunk), true);
             }
+        } else {
+            analysis_done_ += static_cast<int>(missing.size());
         }
+    }
 
-        // Store suggestions
-        for (auto& s : batch_suggestions) {
-            suggestions_.push_back(s);
-        }
+    update_analysis_progress();
+    fill_analysis_queue();
+}
+
+void AiFileTinderDialog::on_analysis_batch_failed(int request_id, const QString& error) {
+    if (!active_batches_.contains(request_id)) return;
+    AnalysisBatch batch = active_batches_.take(request_id);
+    // Keep whatever streamed in before the failure
+    save_batch_to_cache(batch);
 
-        log(QString("Batch %1/%2 complete \xe2\x80\x94 %3 files classified (%4s)")
-            .arg(batch + 1).arg(total_batches).arg(files_classified)
-            .arg(batch_secs, 0, 'f', 1));
+    log_analysis(QString("ERROR: Batch failed: %1").arg(error));
+    if (analysis_stopped_) {
+        analysis_done_ += static_cast<int>(batch.file_indices.size() - batch.received.size());
+        update_analysis_progress();
+        return;
+    }
+
+    // The dispatcher already tried every provider. Retry the batch's
+    // missing files once; after that only they are given up on, and the
+    // rest of the run carries on in the background.
+    QList<int> missing;
+    for (int idx : batch.file_indices) {
+        if (!batch.received.contains(idx)) missing.append(idx);
+    }
+    if (!batch.is_retry && !missing.isEmpty()) {
+        log_analysis(QString("  Requeueing %1 files...").arg(missing.size()));
+        int chunk = batcher_.target_files();
+        for (int start = 0; start < missing.size(); start += chunk) {
+            submit_analysis_batch(missing.mid(start, chunk), true);
+        }
+    } else {
+        analysis_done_ += static_cast<int>(missing.size());
+        log_analysis(QString("  Giving up on %1 files").arg(missing.size()));
+    }
+    update_analysis_progress();
+
+    // Every batch failing means the provider is unusable (bad key, outage);
+    // stop sending and keep the partial results
+    if (++consecutive_batch_failures_ >= kMaxConsecutiveBatchFailures) {
+        log_analysis(QString("Stopping: %1 batches in a row failed").arg(consecutive_batch_failures_));
+        analysis_stopped_ = true;
+        dispatcher_->cancel_all();
+        complete_ai_analysis();
+        return;
+    }
+    fill_analysis_queue();
+}
 
-        prog_bar->setValue(batch + 1);
-        QApplication::processEvents();
+void AiFileTinderDialog::log_provider_stats() {
+    double minutes = std::max(analysis_timer_.elapsed(), qint64(1)) / 60000.0;
+    for (const AiProviderStats& stats : dispatcher_->provider_stats()) {
+        if (stats.completed == 0 && stats.failed == 0 && dispatcher_->provider_count() > 1) {
+            log_analysis(QString("  %1: unused").arg(stats.name));
+            continue;
+        }
+        log_analysis(QString("  %1: %2 ok, %3 failed, %4 rate-limited | avg %5s | ~%6 tokens/min%7")
+            .arg(stats.name).arg(stats.completed).arg(stats.failed).arg(stats.throttled)
+            .arg(stats.avg_latency_ms / 1000.0, 0, 'f', 1)
+            .arg(static_cast<int>(stats.prompt_tokens / minutes))
+            .arg(stats.down ? " (benched)" : ""));
     }
+}
 
-    double total_secs = elapsed.elapsed() / 1000.0;
-    log(QString("Analysis complete -- %1 files classified (%2s)")
-        .arg(files_classified).arg(total_secs, 0, 'f', 1));
+void AiFileTinderDialog::log_analysis(const QString& message) {
+    LOG_INFO("AIMode", message);
+    if (!analysis_log_) return;
+    QString ts = QDateTime::currentDateTime().toString("hh:mm:ss");
+    analysis_log_->append(QString("[%1] %2").arg(ts, message));
+    analysis_log_->verticalScrollBar()->setValue(analysis_log_->verticalScrollBar()->maximum());
+}
 
+void AiFileTinderDialog::finish_ai_analysis() {
     // Handle new categories: add AI-generated folders to the tree
-    if (category_mode_ != AiCategoryMode::KeepExisting) {
-        QSet<QString> new_folders;
-        for (const auto& s : suggestions_) {
-            for (const QString& folder : s.suggested_folders) {
-                if (folder_model_ && !folder_model_->find_node(folder)
-                    && folder != source_folder_) {
-                    new_folders.insert(folder);
-                }
+    if (category_mode_ == AiCategoryMode::KeepExisting) return;
+
+    QSet<QString> new_folders;
+    for (const auto& s : suggestions_) {
+        for (const QString& folder : s.suggested_folders) {
+            if (folder_model_ && !folder_model_->find_node(folder)
+                && folder != source_folder_) {
+                new_folders.insert(folder);
             }
         }
+    }
 
-        // Let user review proposed categories before applying
-        if (!new_folders.isEmpty()) {
-            QDialog review_dlg(this);
-            review_dlg.setWindowTitle("Review AI Categories");
-            review_dlg.setMinimumSize(ui::scaling::scaled(500), ui::scaling::scaled(400));
-            auto* rv_layout = new QVBoxLayout(&review_dlg);
-
-            auto* rv_header = new QLabel(QString("AI proposed %1 new folder(s). Edit, remove, or add categories:")
-                .arg(new_folders.size()));
-            rv_header->setStyleSheet("font-weight: bold; color: #3498db;");
-            rv_header->setWordWrap(true);
-            rv_layout->addWidget(rv_header);
-
-            auto* folder_edit = new QTextEdit();
-            QStringList sorted_folders = new_folders.values();
-            sorted_folders.sort();
-            folder_edit->setPlainText(sorted_folders.join("\n"));
-            folder_edit->setStyleSheet("QTextEdit { background: #1a1a2e; color: #e0e0e0; font-family: monospace; font-size: 11px; }");
-            rv_layout->addWidget(folder_edit, 1);
-
-            auto* rv_note = new QLabel("One folder path per line. Empty lines will be ignored.");
-            rv_note->setStyleSheet("color: #95a5a6; font-size: 10px;");
-            rv_layout->addWidget(rv_note);
-
-            auto* rv_btns = new QHBoxLayout();
-            auto* rv_cancel = new QPushButton("Cancel (use as-is)");
-            connect(rv_cancel, &QPushButton::clicked, &review_dlg, &QDialog::reject);
-            rv_btns->addWidget(rv_cancel);
-            rv_btns->addStretch();
-            auto* rv_ok = new QPushButton("Apply Changes");
-            rv_ok->setStyleSheet("QPushButton { background-color: #3498db; color: white; padding: 6px 16px; border-radius: 4px; }");
-            connect(rv_ok, &QPushButton::clicked, &review_dlg, &QDialog::accept);
-            rv_btns->addWidget(rv_ok);
-            rv_layout->addLayout(rv_btns);
-
-            if (review_dlg.exec() == QDialog::Accepted) {
-                new_folders.clear();
-                QStringList lines = folder_edit->toPlainText().split('\n', Qt::SkipEmptyParts);
-                for (const QString& line : lines) {
-                    QString trimmed = line.trimmed();
-                    if (!trimmed.isEmpty() && trimmed != source_folder_) {
-                        if (!trimmed.startsWith(source_folder_)) {
-                            trimmed = QDir::cleanPath(source_folder_ + "/" + trimmed);
-                        }
-                        new_folders.insert(trimmed);
+    // Let user review proposed categories before applying
+    if (!new_folders.isEmpty()) {
+        QDialog review_dlg(this);
+        review_dlg.setWindowTitle("Review AI Categories");
+        review_dlg.setMinimumSize(ui::scaling::scaled(500), ui::scaling::scaled(400));
+        auto* rv_layout = new QVBoxLayout(&review_dlg);
+
+        auto* rv_header = new QLabel(QString("AI proposed %1 new folder(s). Edit, remove, or add categories:")
+            .arg(new_folders.size()));
+        rv_header->setStyleSheet("font-weight: bold; color: #3498db;");
+        rv_header->setWordWrap(true);
+        rv_layout->addWidget(rv_header);
+
+        auto* folder_edit = new QTextEdit();
+        QStringList sorted_folders = new_folders.values();
+        sorted_folders.sort();
+        folder_edit->setPlainText(sorted_folders.join("\n"));
+        folder_edit->setStyleSheet("QTextEdit { background: #1a1a2e; color: #e0e0e0; font-family: monospace; font-size: 11px; }");
+        rv_layout->addWidget(folder_edit, 1);
+
+        auto* rv_note = new QLabel("One folder path per line. Empty lines will be ignored.");
+        rv_note->setStyleSheet("color: #95a5a6; font-size: 10px;");
+        rv_layout->addWidget(rv_note);
+
+        auto* rv_btns = new QHBoxLayout();
+        auto* rv_cancel = new QPushButton("Cancel (use as-is)");
+        connect(rv_cancel, &QPushButton::clicked, &review_dlg, &QDialog::reject);
+        rv_btns->addWidget(rv_cancel);
+        rv_btns->addStretch();
+        auto* rv_ok = new QPushButton("Apply Changes");
+        rv_ok->setStyleSheet("QPushButton { background-color: #3498db; color: white; padding: 6px 16px; border-radius: 4px; }");
+        connect(rv_ok, &QPushButton::clicked, &review_dlg, &QDialog::accept);
+        rv_btns->addWidget(rv_ok);
+        rv_layout->addLayout(rv_btns);
+
+        if (review_dlg.exec() == QDialog::Accepted) {
+            new_folders.clear();
+            QStringList lines = folder_edit->toPlainText().split('\n', Qt::SkipEmptyParts);
+            for (const QString& line : lines) {
+                QString trimmed = line.trimmed();
+                if (!trimmed.isEmpty() && trimmed != source_folder_) {
+                    if (!trimmed.startsWith(source_folder_)) {
+                        trimmed = QDir::cleanPath(source_folder_ + "/" + trimmed);
                     }
+                    new_folders.insert(trimmed);
                 }
             }
-            log(QString("Categories after review: %1 folder(s)").arg(new_folders.size()));
         }
+        log_analysis(QString("Categories after review: %1 folder(s)").arg(new_folders.size()));
+    }
 
-        if (folder_model_ && !new_folders.isEmpty()) {
-            folder_model_->blockSignals(true);
-            for (const QString& folder : new_folders) {
-                bool is_virtual = !QDir(folder).exists();
-                folder_model_->add_folder(folder, is_virtual);
-            }
-            folder_model_->blockSignals(false);
-            if (mind_map_view_) mind_map_view_->refresh_layout();
-            log(QString("Added %1 new folder(s) to the grid").arg(new_folders.size()));
+    if (folder_model_ && !new_folders.isEmpty()) {
+        folder_model_->blockSignals(true);
+        for (const QString& folder : new_folders) {
+            bool is_virtual = !QDir(folder).exists();
+            folder_model_->add_folder(folder, is_virtual);
         }
+        folder_model_->blockSignals(false);
+        if (mind_map_view_) mind_map_view_->refresh_layout();
+        log_analysis(QString("Added %1 new folder(s) to the grid").arg(new_folders.size()));
     }
+}
 
-    // Wait a moment so user can see the completion message
-    QTimer::singleShot(1500, &progress_dialog, &QDialog::accept);
-    progress_dialog.exec();
+QString AiFileTinderDialog::classification_fingerprint(int file_index) const {
+    const auto& f = files_[file_index];
+    return QString("%1|%2|%3|%4").arg(f.name, f.extension).arg(f.size).arg(f.mime_type);
+}
 
-    // Enable re-run button after first analysis
-    if (rerun_ai_btn_) rerun_ai_btn_->setEnabled(true);
+QString AiFileTinderDialog::classification_config_key() const {
+    // Anything that changes the prompt or the valid answers changes the key
+    QStringList folders = analysis_folders_;
+    folders.sort();
+    QStringList parts;
+    parts << provider_config_.provider_name << provider_config_.model_name
+          << QString::number(static_cast<int>(category_mode_))
+          << QString::number(category_depth_) << folder_purpose_
+          << QString::number(sort_mode_ == AiSortMode::Semi ? semi_count_ : 1)   // Folders asked per file
+          << folders.join('\n');
+    return QString::fromLatin1(QCryptographicHash::hash(parts.join('\x1f').toUtf8(),
+                                                        QCryptographicHash::Sha1).toHex());
+}
 
-    // Apply results based on mode
-    if (sort_mode_ == AiSortMode::Auto) {
-        apply_auto_suggestions();
-    } else {
-        apply_semi_suggestions();
+void AiFileTinderDialog::save_batch_to_cache(const AnalysisBatch& batch) {
+    // The cache key names the primary model; answers from a fallback
+    // provider would be replayed as if the primary had given them
+    if (batch.from_fallback) return;
+    db_.save_ai_classifications(analysis_cache_key_, batch.to_cache);
+}
+
+QString AiFileTinderDialog::suggestion_to_json(const AiFileSuggestion& suggestion) {
+    QJsonObject obj;
+    obj["f"] = QJsonArray::fromStringList(suggestion.suggested_folders);
+    QJsonArray conf;
+    for (int c : suggestion.confidence_scores) conf.append(c);
+    obj["c"] = conf;
+    obj["r"] = suggestion.reasoning;
+    return QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+}
+
+int AiFileTinderDialog::take_cached_classifications(std::vector<int>& file_indices) {
+    QStringList fingerprints;
+    fingerprints.reserve(static_cast<qsizetype>(file_indices.size()));
+    for (int idx : file_indices) fingerprints.append(classification_fingerprint(idx));
+    QHash<QString, QString> cached = db_.get_ai_classifications(analysis_cache_key_, fingerprints);
+    if (cached.isEmpty()) return 0;
+
+    // Rebuild a response-shaped array so cached entries go through the same
+    // validation as fresh ones
+    QJsonArray arr;
+    for (size_t i = 0; i < file_indices.size(); ++i) {
+        auto it = cached.constFind(fingerprints[static_cast<qsizetype>(i)]);
+        if (it == cached.constEnd()) continue;
+        QJsonObject obj = QJsonDocument::fromJson(it.value().toUtf8()).object();
+        obj["i"] = file_indices[i];
+        arr.append(obj);
+    }
+    QSet<int> hits;
+    for (auto& s : parse_ai_response(QString::fromUtf8(QJsonDocument(arr).toJson(QJsonDocument::Compact)))) {
+        if (hits.contains(s.file_index)) continue;
+        hits.insert(s.file_index);
+        suggestions_.push_back(s);
+    }
+
+    file_indices.erase(std::remove_if(file_indices.begin(), file_indices.end(),
+                                      [&hits](int idx) { return hits.contains(idx); }),
+                       file_indices.end());
+    return static_cast<int>(hits.size());
+}
+
+int AiFileTinderDialog::take_local_classifications(std::vector<int>& file_indices) {
+    // New-category modes want the model's own structure, not the old one
+    if (category_mode_ != AiCategoryMode::KeepExisting && category_mode_ != AiCategoryMode::KeepPlusGenerate)
+        return 0;
+
+    // Past decisions about the files being analysed would just be replayed
+    // as "predictions" (full re-analysis includes already-sorted files)
+    QSet<QString> run_paths;
+    run_paths.reserve(static_cast<qsizetype>(file_indices.size()));
+    for (int idx : file_indices) run_paths.insert(files_[idx].path);
+
+    LocalPreClassifier classifier;
+    classifier.set_allowed_folders(analysis_folders_);
+    QMimeDatabase mime_db;
+    for (const auto& d : db_.get_recent_move_decisions()) {
+        if (!analysis_folders_.contains(d.destination_folder) || run_paths.contains(d.file_path)) continue;
+        QString name = QFileInfo(d.file_path).fileName();
+        classifier.add_example(name, mime_db.mimeTypeForFile(name, QMimeDatabase::MatchExtension).name(),
+                               d.destination_folder);
+    }
+    for (const auto& c : corrections_) {
+        if (c.file_index < 0 || c.file_index >= static_cast<int>(files_.size())) continue;
+        const auto& f = files_[c.file_index];
+        classifier.add_example(f.name, f.mime_type, c.user_chose);
+    }
+    if (classifier.example_count() == 0) return 0;
+
+    QSet<int> assigned;
+    for (int idx : file_indices) {
+        const auto& f = files_[idx];
+        PreClassification result = classifier.classify(f.name, f.mime_type);
+        if (!classifier.is_confident(result)) continue;
+
+        AiFileSuggestion s;
+        s.file_index = idx;
+        s.suggested_folders << result.folder << result.alternates;
+        s.confidence_scores << qRound(result.confidence * 100);
+        while (s.confidence_scores.size() < s.suggested_folders.size()) s.confidence_scores.append(0);
+        s.reasoning = QString("Local match: named like %1 past files moved here").arg(result.support);
+        suggestions_.push_back(s);
+        assigned.insert(idx);
     }
+
+    file_indices.erase(std::remove_if(file_indices.begin(), file_indices.end(),
+                                      [&assigned](int idx) { return assigned.contains(idx); }),
+                       file_indices.end());
+    return static_cast<int>(assigned.size());
 }
 
-QString AiFileTinderDialog::build_analysis_prompt(const QStringList& file_descriptions,
-                                                   const QStringList& available_folders) {
+QString AiFileTinderDialog::describe_file(int file_index, const QString& previous_name) const {
+    const auto& f = files_[file_index];
+    // Shared-prefix compression against the previous line's name
+    int shared = 0;
+    int limit = static_cast<int>(qMin(previous_name.size(), f.name.size()));
+    while (shared < limit && previous_name[shared] == f.name[shared]) ++shared;
+    QString name = shared >= kMinSharedPrefix
+        ? QString("~%1:%2").arg(shared).arg(f.name.mid(shared))
+        : f.name;
+    QString line = QString("%1|%2|%3|%4").arg(file_index).arg(name, compact_size(f.size), QString(mime_code(f.mime_type, f.extension)));
+    QString hint = content_hints_.value(file_index);
+    return hint.isEmpty() ? line : line + "|" + hint;
+}
+
+QString AiFileTinderDialog::build_analysis_preamble(const QStringList& available_folders) const {
     QString prompt;
     int suggestion_count = (sort_mode_ == AiSortMode::Semi) ? semi_count_ : 1;
 
@@ -1152,16 +1626,17 @@ QString AiFileTinderDialog::build_analysis_prompt(const QStringList& file_descri
 
     prompt += "\nSource folder (root): " + source_folder_ + "\n";
 
+    // Folders by ID, relative to the root; the model answers with the IDs
     if (!available_folders.isEmpty() && category_mode_ != AiCategoryMode::GenerateNew) {
-        prompt += "\nExisting folders:\n";
-        for (const QString& f : available_folders) {
-            prompt += "  - " + f + "\n";
+        prompt += "\nExisting folders (ID = path relative to root):\n";
+        for (int i = 0; i < available_folders.size(); ++i) {
+            prompt += QString("F%1 = %2\n").arg(i).arg(folder_display_path(available_folders[i]));
         }
     }
 
     prompt += QString("\nFor each file, suggest the top %1 best-matching folder(s), ordered by confidence.\n")
         .arg(suggestion_count);
-    prompt += "New folder paths MUST be under the source folder root.\n";
+    prompt += "Refer to an existing folder by its ID (\"F3\"). Give a new folder as a path relative to the root.\n";
     prompt += "IMPORTANT: Use spaces in folder names, not underscores or camelCase. Example: 'Audio Plugins' not 'Audio_Plugins'.\n\n";
 
     // Include correction feedback if we have any (learning from user overrides)
@@ -1181,170 +1656,106 @@ QString AiFileTinderDialog::build_analysis_prompt(const QStringList& file_descri
         prompt += "\n";
     }
 
-    prompt += "Files (format: index|name|extension|size_bytes|mime_type):\n";
-    for (const QString& desc : file_descriptions) {
-        prompt += desc + "\n";
-    }
+    prompt += "Files are listed as index|name|size|type.\n";
+    prompt += "  - \"~N:\" at the start of a name stands for the first N characters of the previous name.\n";
+    prompt += "  - Sizes use K/M/G suffixes.\n";
+    prompt += "  - Types: i=image v=video a=audio t=text d=document s=spreadsheet p=presentation "
+              "z=archive x=executable f=font o=other.\n";
+    prompt += "  - An optional 5th field is a hint from the file's content: document title, "
+              "photo date and camera, audio tags, or the first words of a text file.\n";
 
     prompt += "\nRespond with ONLY a JSON array. Each element:\n";
-    prompt += "  {\"i\": <file_index>, \"f\": [\"<full_folder_path>\", ...], \"c\": [<confidence_pct>, ...], \"r\": \"<short_reasoning>\"}\n";
+    prompt += "  {\"i\": <file_index>, \"f\": [\"<folder ID or new relative path>\", ...], \"c\": [<confidence_pct>, ...], \"r\": \"<reason, max 8 words>\"}\n";
     prompt += "Where \"c\" is an array of confidence percentages (0-100) matching each folder in \"f\".\n";
-    prompt += "Example: [{\"i\":0,\"f\":[\"" + source_folder_ + "/Images\"],\"c\":[92],\"r\":\"JPEG photo\"}]\n";
-    prompt += "Return ONLY the JSON array, no markdown, no explanation.\n";
+    prompt += "Example: [{\"i\":0,\"f\":[\"F2\",\"Photos/2024\"],\"c\":[92,40],\"r\":\"JPEG photo\"}]\n";
+    prompt += "Return ONLY the JSON array, no markdown, no explanation.\n\n";
 
     return prompt;
 }
 
-QString AiFileTinderDialog::send_api_request(const QString& prompt, QString& error_out) {
-    QUrl url(provider_config_.endpoint_url);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-
-    int timeout = provider_config_.is_local ? kLocalTimeoutMs : kCloudTimeoutMs;
-    request.setTransferTimeout(timeout);
-
-    // Set auth headers
-    if (!provider_config_.api_key.isEmpty()) {
-        if (provider_config_.provider_name == "Anthropic") {
-            request.setRawHeader("x-api-key", provider_config_.api_key.toUtf8());
-            request.setRawHeader("anthropic-version", "2023-06-01");
-        } else if (provider_config_.provider_name != "Google Gemini") {
-            request.setRawHeader("Authorization",
-                QByteArray("Bearer ") + provider_config_.api_key.toUtf8());
-        }
+QString AiFileTinderDialog::build_batch_prompt(const QList<int>& file_indices) const {
+    QString prompt = "Files:\n";
+    QString previous;
+    for (int idx : file_indices) {
+        prompt += describe_file(idx, previous) + "\n";
+        previous = files_[idx].name;
     }
+    return prompt;
+}
 
-    // Build request body
-    QJsonObject body;
-
-    if (provider_config_.provider_name == "Anthropic") {
-        body["model"] = provider_config_.model_name;
-        body["max_tokens"] = 4096;
-        QJsonArray messages;
-        QJsonObject msg;
-        msg["role"] = "user";
-        msg["content"] = prompt;
-        messages.append(msg);
-        body["messages"] = messages;
-    } else if (provider_config_.provider_name == "Google Gemini") {
-        // Gemini uses different URL/body structure
-        QString gemini_url = QString("%1/%2:generateContent?key=%3")
-            .arg(provider_config_.endpoint_url,
-                 provider_config_.model_name,
-                 provider_config_.api_key);
-        url = QUrl(gemini_url);
-        request.setUrl(url);
-        request.setRawHeader("Authorization", QByteArray());
-
-        QJsonObject contents;
-        QJsonArray parts;
-        QJsonObject part;
-        part["text"] = prompt;
-        parts.append(part);
-        contents["parts"] = parts;
-        QJsonArray contents_arr;
-        contents_arr.append(contents);
-        body["contents"] = contents_arr;
-    } else {
-        // OpenAI-compatible (OpenAI, Groq, OpenRouter, Mistral, Ollama, LM Studio)
-        body["model"] = provider_config_.model_name;
-        body["temperature"] = 0.3;
-        body["max_tokens"] = 4096;
-        QJsonArray messages;
-        QJsonObject sys_msg;
-        sys_msg["role"] = "system";
-        sys_msg["content"] = QString("You are a file organization assistant. Respond only with the exact JSON array requested. No markdown formatting.");
-        messages.append(sys_msg);
-        QJsonObject user_msg;
-        user_msg["role"] = "user";
-        user_msg["content"] = prompt;
-        messages.append(user_msg);
-        body["messages"] = messages;
-    }
-
-    requests_this_minute_++;
-    last_request_ms_ = QDateTime::currentMSecsSinceEpoch();
-
-    // Smart retry loop: automatic backoff on 429 (rate limited)
-    int max_retries = is_free_tier_ ? 4 : 2;
-    for (int attempt = 0; attempt <= max_retries; ++attempt) {
-        QNetworkReply* reply = network_manager_->post(request, QJsonDocument(body).toJson());
-
-        QEventLoop loop;
-        connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
-
-        int http_status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-
-        if (http_status == 429 && attempt < max_retries) {
-            // Rate limited — exponential backoff
-            consecutive_429s_++;
-            int retry_after = 5;
-            QByteArray retry_hdr = reply->rawHeader("Retry-After");
-            if (!retry_hdr.isEmpty()) retry_after = qMax(retry_hdr.toInt(), 1);
-            // Exponential backoff: retry_after * 2^attempt, capped at 120s
-            int backoff_secs = qMin(retry_after * (1 << attempt), 120);
-            reply->deleteLater();
-
-            LOG_INFO("AIMode", QString("429 rate limited, retry %1/%2 in %3s")
-                .arg(attempt + 1).arg(max_retries).arg(backoff_secs));
-            QEventLoop backoff_loop;
-            QTimer::singleShot(backoff_secs * 1000, &backoff_loop, &QEventLoop::quit);
-            backoff_loop.exec();
-            continue;
-        }
-
-        if (reply->error() != QNetworkReply::NoError) {
-            error_out = reply->errorString();
-            QString resp_body = reply->readAll();
-            if (!resp_body.isEmpty()) {
-                error_out += " -- " + resp_body.left(300);
-            }
-            reply->deleteLater();
-            return {};
-        }
-
-        // Success — decay 429 counter (gradual recovery instead of hard reset)
-        if (consecutive_429s_ > 0) consecutive_429s_--;
+QString AiFileTinderDialog::folder_display_path(const QString& folder) const {
+    if (folder == source_folder_) return "/ (root)";
+    if (folder.startsWith(source_folder_ + "/")) return folder.mid(source_folder_.size() + 1);
+    return folder;  // Outside the root: keep absolute
+}
 
-        QByteArray response_data = reply->readAll();
-        reply->deleteLater();
+QString AiFileTinderDialog::resolve_folder_reference(const QString& reference) const {
+    static const QRegularExpression id_pattern("^F(\\d+)$");
+    QString ref = reference.trimmed();
+    QRegularExpressionMatch match = id_pattern.match(ref);
+    if (match.hasMatch()) {
+        int id = match.captured(1).toInt();
+        return (id >= 0 && id < analysis_folders_.size()) ? analysis_folders_[id] : QString();
+    }
+    if (ref.isEmpty()) return QString();
+    if (QDir::isAbsolutePath(ref)) return QDir::cleanPath(ref);
+    if (ref.startsWith("/ (root)")) ref = ref.mid(8);
+    return QDir::cleanPath(source_folder_ + "/" + ref);
+}
 
-        QJsonDocument doc = QJsonDocument::fromJson(response_data);
-        QString content_text;
+QString AiFileTinderDialog::compact_size(qint64 bytes) {
+    if (bytes < 1024) return QString::number(bytes);
+    const char* units = "KMGT";
+    double value = bytes / 1024.0;
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3) {
+        value /= 1024.0;
+        ++unit;
+    }
+    return QString::number(value, 'f', value < 10.0 ? 1 : 0) + QChar(units[unit]);
+}
 
-        if (provider_config_.provider_name == "Anthropic") {
-            QJsonArray content_arr = doc.object()["content"].toArray();
-            if (!content_arr.isEmpty()) {
-                content_text = content_arr[0].toObject()["text"].toString();
-            }
-        } else if (provider_config_.provider_name == "Google Gemini") {
-            QJsonArray candidates = doc.object()["candidates"].toArray();
-            if (!candidates.isEmpty()) {
-                QJsonObject content = candidates[0].toObject()["content"].toObject();
-                QJsonArray parts = content["parts"].toArray();
-                if (!parts.isEmpty()) {
-                    content_text = parts[0].toObject()["text"].toString();
-                }
-            }
-        } else {
-            QJsonArray choices = doc.object()["choices"].toArray();
-            if (!choices.isEmpty()) {
-                content_text = choices[0].toObject()["message"].toObject()["content"].toString();
-            }
-        }
+QChar AiFileTinderDialog::mime_code(const QString& mime_type, const QString& extension) {
+    if (mime_type.startsWith("image/")) return 'i';
+    if (mime_type.startsWith("video/")) return 'v';
+    if (mime_type.startsWith("audio/")) return 'a';
+    if (mime_type.startsWith("font/") || mime_type.contains("font")) return 'f';
+    if (mime_type.contains("spreadsheet") || mime_type.contains("excel")) return 's';
+    if (mime_type.contains("presentation") || mime_type.contains("powerpoint")) return 'p';
+    if (mime_type == "application/pdf" || mime_type.contains("document") || mime_type.contains("msword")
+        || mime_type.contains("epub") || mime_type == "application/rtf") return 'd';
+    if (mime_type.contains("zip") || mime_type.contains("compressed") || mime_type.contains("tar")
+        || mime_type.contains("rar") || mime_type.contains("7z")) return 'z';
+    if (mime_type.contains("executable") || mime_type.contains("sharedlib") || mime_type.contains("msdownload")
+        || mime_type.contains("msi") || extension.compare("dll", Qt::CaseInsensitive) == 0) return 'x';
+    if (mime_type.startsWith("text/") || mime_type.contains("json") || mime_type.contains("xml")) return 't';
+    return 'o';
+}
 
-        if (content_text.isEmpty()) {
-            error_out = "Empty response from AI";
-            return {};
-        }
 
-        return content_text;
+AiFileSuggestion AiFileTinderDialog::parse_suggestion_object(const QJsonObject& obj) const {
+    AiFileSuggestion s;
+    s.file_index = obj["i"].toInt(-1);
+    if (s.file_index < 0 || s.file_index >= static_cast<int>(files_.size())) {
+        s.file_index = -1;
+        return s;
     }
-
-    // All retries exhausted
-    error_out = "Rate limited after multiple retries";
-    return {};
+    QJsonArray folders = obj["f"].toArray();
+    for (const QJsonValue& fv : folders) {
+        QString folder = resolve_folder_reference(fv.toString());
+        if (!folder.isEmpty()) s.suggested_folders.append(folder);
+    }
+    // Parse confidence scores (optional)
+    QJsonArray conf_arr = obj["c"].toArray();
+    for (const QJsonValue& cv : conf_arr) {
+        s.confidence_scores.append(qBound(0, cv.toInt(50), 100));
+    }
+    // Pad confidence to match folder count if fewer provided
+    while (s.confidence_scores.size() < s.suggested_folders.size()) {
+        s.confidence_scores.append(50);
+    }
+    s.reasoning = obj["r"].toString();
+    return s;
 }
 
 std::vector<AiFileSuggestion> AiFileTinderDialog::parse_ai_response(
@@ -1352,30 +1763,7 @@ std::vector<AiFileSuggestion> AiFileTinderDialog::parse_ai_response(
 
     std::vector<AiFileSuggestion> results;
 
-    auto parse_suggestion = [this](const QJsonObject& obj) -> AiFileSuggestion {
-        AiFileSuggestion s;
-        s.file_index = obj["i"].toInt(-1);
-        if (s.file_index < 0 || s.file_index >= static_cast<int>(files_.size())) {
-            s.file_index = -1;
-            return s;
-        }
-        QJsonArray folders = obj["f"].toArray();
-        for (const QJsonValue& fv : folders) {
-            QString folder = fv.toString();
-            if (!folder.isEmpty()) s.suggested_folders.append(folder);
-        }
-        // Parse confidence scores (optional)
-        QJsonArray conf_arr = obj["c"].toArray();
-        for (const QJsonValue& cv : conf_arr) {
-            s.confidence_scores.append(qBound(0, cv.toInt(50), 100));
-        }
-        // Pad confidence to match folder count if fewer provided
-        while (s.confidence_scores.size() < s.suggested_folders.size()) {
-            s.confidence_scores.append(50);
-        }
-        s.reasoning = obj["r"].toString();
-        return s;
-    };
+    auto parse_suggestion = [this](const QJsonObject& obj) { return parse_suggestion_object(obj); };
 
     // Level 1: Try full JSON parse
     QJsonDocument doc = QJsonDocument::fromJson(response.toUtf8());
@@ -1439,6 +1827,7 @@ void AiFileTinderDialog::apply_auto_suggestions() {
             valid_folders.insert(p);
     }
 
+    QHash<QString, int> assigned;
     for (const auto& s : suggestions_) {
         if (s.file_index < 0 || s.file_index >= static_cast<int>(files_.size())) continue;
 
@@ -1463,9 +1852,10 @@ void AiFileTinderDialog::apply_auto_suggestions() {
             file.decision = "move";
             file.destination_folder = dest;
             move_count_++;
-            if (folder_model_) folder_model_->assign_file_to_folder(dest);
+            assigned[dest]++;
         }
     }
+    if (folder_model_) folder_model_->apply_assignment_deltas(assigned);
 
     save_session_state();
     update_stats();
@@ -1477,7 +1867,8 @@ void AiFileTinderDialog::apply_auto_suggestions() {
 
 void AiFileTinderDialog::apply_semi_suggestions() {
     LOG_INFO("AIMode", QString("Semi mode \xe2\x80\x94 %1 suggestions ready").arg(suggestions_.size()));
-    current_filtered_index_ = 0;
+    // The user may have kept sorting during analysis; only restart when at the end
+    if (current_filtered_index_ >= static_cast<int>(filtered_indices_.size())) current_filtered_index_ = 0;
     update_progress();
     show_current_file();
 }
@@ -1485,6 +1876,8 @@ void AiFileTinderDialog::apply_semi_suggestions() {
 void AiFileTinderDialog::show_current_file() {
     clear_folder_highlights();
     AdvancedFileTinderDialog::show_current_file();
+    // Keep the background analysis working just ahead of the user
+    if (analysis_running_) prioritize_pending();
 
     // In semi mode, highlight AI-suggested folders
     if (sort_mode_ == AiSortMode::Semi && !suggestions_.empty()) {
@@ -1602,11 +1995,3 @@ void AiFileTinderDialog::on_folder_clicked_from_ai(const QString& folder_path) {
     save_session_state();
     advance_to_next();
 }
-
-bool AiFileTinderDialog::check_rate_limit() {
-    return requests_this_minute_ < provider_config_.rate_limit_rpm;
-}
-
-void AiFileTinderDialog::reset_rate_limit() {
-    requests_this_minute_ = 0;
-}
@@ -0,0 +1,575 @@
+#include "AiRequestDispatcher.hpp"
+#include "AdaptiveBatcher.hpp"
+#include "AppLogger.hpp"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QTimer>
+#include <QUrl>
+#include <QFile>
+#include <QCryptographicHash>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+// ── TokenBucket ────────────────────────────────────────────
+
+void TokenBucket::configure(double capacity, double refill_per_minute) {
+    capacity_ = std::max(0.0, capacity);
+    tokens_ = capacity_;
+    refill_per_ms_ = refill_per_minute / 60000.0;
+    last_refill_ms_ = QDateTime::currentMSecsSinceEpoch();
+}
+
+void TokenBucket::refill() {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    tokens_ = std::min(capacity_, tokens_ + (now - last_refill_ms_) * refill_per_ms_);
+    last_refill_ms_ = now;
+}
+
+bool TokenBucket::try_take(double amount) {
+    if (capacity_ <= 0.0) return true;
+    refill();
+    // Requests larger than the whole bucket go through once it is full
+    amount = std::min(amount, capacity_);
+    if (tokens_ < amount) return false;
+    tokens_ -= amount;
+    return true;
+}
+
+int TokenBucket::wait_ms(double amount) {
+    if (capacity_ <= 0.0 || refill_per_ms_ <= 0.0) return 0;
+    refill();
+    amount = std::min(amount, capacity_);
+    if (tokens_ >= amount) return 0;
+    return static_cast<int>(std::ceil((amount - tokens_) / refill_per_ms_));
+}
+
+// ── JsonArrayStreamParser ──────────────────────────────────
+
+void JsonArrayStreamParser::reset() {
+    depth_ = 0;
+    in_string_ = false;
+    escape_ = false;
+    current_.clear();
+}
+
+QList<QJsonObject> JsonArrayStreamParser::feed(QStringView chunk) {
+    QList<QJsonObject> objects;
+    for (QChar c : chunk) {
+        if (depth_ == 0) {
+            if (c == '[') depth_ = 1;
+            continue;
+        }
+        if (depth_ == 1) {
+            // Between elements: only an object opens a new one
+            if (c == '{') {
+                depth_ = 2;
+                current_ = c;
+            } else if (c == ']') {
+                depth_ = 0;
+            }
+            continue;
+        }
+
+        current_ += c;
+        if (in_string_) {
+            if (escape_) escape_ = false;
+            else if (c == '\\') escape_ = true;
+            else if (c == '"') in_string_ = false;
+            continue;
+        }
+        if (c == '"') {
+            in_string_ = true;
+        } else if (c == '{' || c == '[') {
+            ++depth_;
+        } else if (c == '}' || c == ']') {
+            if (--depth_ == 1) {
+                QJsonDocument doc = QJsonDocument::fromJson(current_.toUtf8());
+                if (doc.isObject()) objects.append(doc.object());
+                current_.clear();
+            }
+        }
+    }
+    return objects;
+}
+
+// ── AiRequestDispatcher ────────────────────────────────────
+
+AiRequestDispatcher::AiRequestDispatcher(QObject* parent)
+    : QObject(parent)
+    , network_manager_(new QNetworkAccessManager(this))
+    , pump_timer_(new QTimer(this)) {
+    pump_timer_->setSingleShot(true);
+    connect(pump_timer_, &QTimer::timeout, this, &AiRequestDispatcher::pump);
+    lanes_.resize(1);
+}
+
+void AiRequestDispatcher::configure(const AiProviderConfig& config) {
+    configure(QList<AiProviderConfig>{config});
+}
+
+void AiRequestDispatcher::configure(const QList<AiProviderConfig>& pool) {
+    lanes_.clear();
+    for (const AiProviderConfig& config : pool) {
+        Lane lane;
+        lane.config = config;
+        int max_concurrent = std::max(1, config.is_free_tier ? 1 : config.max_concurrent);
+        lane.concurrency_limit = max_concurrent;
+        lane.config.max_concurrent = max_concurrent;
+
+        // Burst no larger than what we could have in flight anyway, so a
+        // strict per-second limiter upstream isn't hit by a full minute at once
+        int rpm = std::max(1, config.rate_limit_rpm);
+        lane.request_bucket.configure(std::min(rpm, max_concurrent), rpm);
+        lane.token_bucket.configure(config.rate_limit_tpm, config.rate_limit_tpm);
+        lane.stats.name = QString("%1 / %2").arg(config.provider_name, config.model_name);
+        lanes_.push_back(lane);
+    }
+    if (lanes_.empty()) lanes_.resize(1);
+}
+
+int AiRequestDispatcher::max_concurrency() const {
+    int total = 0;
+    for (const Lane& lane : lanes_) total += lane.config.max_concurrent;
+    return std::max(1, total);
+}
+
+QList<AiProviderStats> AiRequestDispatcher::provider_stats() const {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QList<AiProviderStats> stats;
+    for (const Lane& lane : lanes_) {
+        AiProviderStats entry = lane.stats;
+        entry.down = now < lane.down_until_ms;
+        stats.append(entry);
+    }
+    return stats;
+}
+
+int AiRequestDispatcher::submit(const QString& prompt, int estimated_tokens, const QString& cacheable_prefix) {
+    PendingRequest request;
+    request.id = next_id_++;
+    request.prefix = cacheable_prefix;
+    request.prompt = prompt;
+    request.tokens = std::max(1, estimated_tokens);
+    queue_.push_back(request);
+    // Defer so callers can connect/submit a whole batch before anything starts
+    schedule_pump(0);
+    return request.id;
+}
+
+void AiRequestDispatcher::cancel_all() {
+    queue_.clear();
+    pump_timer_->stop();
+    // Forget replies first so their finished() is ignored in handle_reply
+    QList<QNetworkReply*> replies = replies_.keys();
+    replies_.clear();
+    in_flight_ = 0;
+    for (Lane& lane : lanes_) lane.in_flight = 0;
+    for (QNetworkReply* reply : replies) {
+        reply->abort();
+    }
+}
+
+void AiRequestDispatcher::schedule_pump(int delay_ms) {
+    delay_ms = std::max(0, delay_ms);
+    if (pump_timer_->isActive() && pump_timer_->remainingTime() <= delay_ms) return;
+    pump_timer_->start(delay_ms);
+}
+
+int AiRequestDispatcher::pick_lane(const PendingRequest& request, qint64 now, int& wait_ms) {
+    int best = -1;
+    double best_score = 0.0;
+    for (int i = 0; i < static_cast<int>(lanes_.size()); ++i) {
+        if (request.failed_lanes.contains(i)) continue;
+        Lane& lane = lanes_[i];
+        qint64 blocked_until = std::max(lane.hold_until_ms, lane.down_until_ms);
+        if (now < blocked_until) {
+            wait_ms = std::min(wait_ms, static_cast<int>(blocked_until - now));
+            continue;
+        }
+        // A full lane frees up when one of its replies lands, which pumps again
+        if (lane.in_flight >= lane.concurrency_limit) continue;
+        int budget_wait = std::max(lane.request_bucket.wait_ms(1), lane.token_bucket.wait_ms(request.tokens));
+        if (budget_wait > 0) {
+            wait_ms = std::min(wait_ms, budget_wait);
+            continue;
+        }
+        // Expected time to an answer; unmeasured lanes score 0 so each gets
+        // probed once, and ties go to the earlier (preferred) provider
+        double score = lane.latency_ms * (lane.in_flight + 1);
+        if (best < 0 || score < best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+void AiRequestDispatcher::pump() {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int wait = INT_MAX;
+    // Scan the whole queue: a request that already failed on the only free
+    // provider must not hold back the ones behind it
+    for (auto it = queue_.begin(); it != queue_.end();) {
+        int lane = pick_lane(*it, now, wait);
+        if (lane < 0) {
+            ++it;
+            continue;
+        }
+        lanes_[lane].request_bucket.try_take(1);
+        lanes_[lane].token_bucket.try_take(it->tokens);
+        PendingRequest request = *it;
+        queue_.erase(it);
+        start_request(lane, request);
+        it = queue_.begin();
+    }
+    if (queue_.empty() || wait == INT_MAX) return;
+    if (wait >= 1000 && !pump_timer_->isActive()) {
+        emit throttled(QString("Rate budget reached"), wait);
+    }
+    schedule_pump(wait);
+}
+
+void AiRequestDispatcher::start_request(int lane, const PendingRequest& request) {
+    const AiProviderConfig& config = lanes_[lane].config;
+    QByteArray body;
+    QNetworkRequest net_request = build_request(config, request.prefix, request.prompt, body);
+    QNetworkReply* reply = network_manager_->post(net_request, body);
+    ActiveReply active;
+    active.request_id = request.id;
+    active.lane = lane;
+    replies_.insert(reply, active);
+    ++lanes_[lane].in_flight;
+    ++in_flight_;
+
+    qint64 started_ms = QDateTime::currentMSecsSinceEpoch();
+    if (config.streaming) {
+        connect(reply, &QNetworkReply::readyRead, this, [this, reply]() {
+            handle_stream_data(reply);
+        });
+    }
+    connect(reply, &QNetworkReply::finished, this, [this, reply, request, started_ms]() {
+        handle_reply(reply, request, started_ms);
+    });
+}
+
+void AiRequestDispatcher::handle_stream_data(QNetworkReply* reply) {
+    auto it = replies_.find(reply);
+    if (it == replies_.end()) return;
+    // Error bodies and servers that ignored "stream" are read whole in handle_reply
+    int http_status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (http_status < 200 || http_status >= 300) return;
+    if (!reply->header(QNetworkRequest::ContentTypeHeader).toString().contains("text/event-stream")) return;
+
+    ActiveReply& active = it.value();
+    const AiProviderConfig& config = lanes_[active.lane].config;
+    active.streamed = true;
+    active.sse_buffer += reply->readAll();
+
+    QList<QJsonObject> objects;
+    int line_start = 0;
+    int newline;
+    while ((newline = active.sse_buffer.indexOf('\n', line_start)) >= 0) {
+        QByteArray line = active.sse_buffer.mid(line_start, newline - line_start);
+        line_start = newline + 1;
+        if (line.endsWith('\r')) line.chop(1);
+        if (!line.startsWith("data:")) continue;  // event:, id:, comments, blank separators
+        QByteArray payload = line.mid(5).trimmed();
+        if (payload.isEmpty() || payload == "[DONE]") continue;
+
+        QString delta = extract_stream_delta(config, QJsonDocument::fromJson(payload).object());
+        if (delta.isEmpty()) continue;
+        active.content += delta;
+        objects += active.parser.feed(delta);
+    }
+    active.sse_buffer.remove(0, line_start);
+
+    // Emit last: a slot may cancel, which invalidates `active`
+    int request_id = active.request_id;
+    int provider = active.lane;
+    for (const QJsonObject& object : objects) {
+        if (!replies_.contains(reply)) break;
+        emit object_received(request_id, object, provider);
+    }
+}
+
+void AiRequestDispatcher::handle_reply(QNetworkReply* reply, PendingRequest request, qint64 started_ms) {
+    reply->deleteLater();
+    // Flush events that arrived together with finished()
+    if (reply->bytesAvailable() > 0) handle_stream_data(reply);
+    if (!replies_.contains(reply)) return;  // Cancelled
+    ActiveReply active = replies_.take(reply);
+    Lane& lane = lanes_[active.lane];
+    --lane.in_flight;
+    --in_flight_;
+
+    int http_status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    int max_retries = lane.config.is_free_tier ? 4 : 2;
+
+    if (http_status == 429 && request.attempts < max_retries) {
+        // Rate limited — back off this provider, not just this request;
+        // other providers in the pool may pick the request up meanwhile
+        // The server's Retry-After is honoured as given; without one, back
+        // off exponentially
+        int retry_after = parse_retry_after(reply->rawHeader("Retry-After"));
+        int backoff_secs = retry_after > 0 ? retry_after
+                                           : std::min(5 * (1 << request.attempts), kMaxBackoffSecs);
+        ++request.attempts;
+        ++lane.stats.throttled;
+
+        lane.hold_until_ms = std::max(lane.hold_until_ms, QDateTime::currentMSecsSinceEpoch() + backoff_secs * 1000LL);
+        lane.concurrency_limit = std::max(1, lane.concurrency_limit / 2);
+        lane.successes_since_throttle = 0;
+        queue_.push_front(request);
+
+        LOG_INFO("AIMode", QString("429 rate limited by %1, retry %2/%3 in %4s (concurrency now %5)")
+            .arg(lane.config.provider_name).arg(request.attempts).arg(max_retries)
+            .arg(backoff_secs).arg(lane.concurrency_limit));
+        if (lanes_.size() == 1) {
+            emit throttled(QString("HTTP 429 (retry %1/%2)").arg(request.attempts).arg(max_retries),
+                           backoff_secs * 1000);
+            schedule_pump(backoff_secs * 1000);
+        } else {
+            pump();
+        }
+        return;
+    }
+
+    QString error;
+    QString content;
+    if (http_status == 429) {
+        error = "Rate limited after multiple retries";
+    } else if (reply->error() != QNetworkReply::NoError) {
+        error = reply->errorString();
+        QString resp_body = reply->readAll();
+        if (!resp_body.isEmpty()) {
+            error += " -- " + resp_body.left(300);
+        }
+    } else {
+        content = active.streamed ? active.content : extract_content(lane.config, reply->readAll());
+        if (content.isEmpty()) error = "Empty response from AI";
+    }
+
+    if (!error.isEmpty()) {
+        // Transport errors, timeouts and 5xx are the provider's fault; other
+        // 4xx and empty answers come from this prompt and must not bench it
+        bool provider_fault = http_status == 0 || http_status >= 500;
+        if (!fail_over(active.lane, request, error, provider_fault)) emit request_failed(request.id, error);
+    } else {
+        qint64 elapsed_ms = QDateTime::currentMSecsSinceEpoch() - started_ms;
+        lane.consecutive_failures = 0;
+        lane.latency_ms = lane.latency_ms <= 0.0
+            ? elapsed_ms : lane.latency_ms + kLatencySmoothing * (elapsed_ms - lane.latency_ms);
+        ++lane.stats.completed;
+        lane.stats.prompt_tokens += request.tokens;
+        lane.stats.avg_latency_ms += (elapsed_ms - lane.stats.avg_latency_ms) / lane.stats.completed;
+        // Additive increase after a window of clean responses
+        if (++lane.successes_since_throttle >= lane.concurrency_limit
+            && lane.concurrency_limit < lane.config.max_concurrent) {
+            ++lane.concurrency_limit;
+            lane.successes_since_throttle = 0;
+        }
+        if (!record_path_.isEmpty()) record_response(lane, request, content, elapsed_ms);
+        emit request_finished(request.id, content, elapsed_ms, active.lane);
+    }
+
+    pump();
+    if (is_idle()) emit all_done();
+}
+
+bool AiRequestDispatcher::fail_over(int lane_index, PendingRequest& request, const QString& error, bool bench_lane) {
+    Lane& lane = lanes_[lane_index];
+    ++lane.stats.failed;
+    if (lanes_.size() == 1) return false;
+
+    if (bench_lane) {
+        // Bench the provider, longer each time it fails in a row
+        ++lane.consecutive_failures;
+        int cooldown = std::min(kFailoverCooldownMs << std::min(lane.consecutive_failures - 1, 4), kMaxCooldownMs);
+        lane.down_until_ms = QDateTime::currentMSecsSinceEpoch() + cooldown;
+        LOG_WARN("AIMode", QString("%1 failed (%2); benched for %3s")
+            .arg(lane.stats.name, error.left(120)).arg(cooldown / 1000));
+        emit provider_failed_over(lane.stats.name, error);
+    } else {
+        // The provider is fine; only this request moves on
+        LOG_WARN("AIMode", QString("%1 rejected request %2 (%3)")
+            .arg(lane.stats.name).arg(request.id).arg(error.left(120)));
+    }
+
+    request.failed_lanes.insert(lane_index);
+    if (request.failed_lanes.size() >= static_cast<int>(lanes_.size())) return false;
+    request.attempts = 0;
+    queue_.push_front(request);
+    return true;
+}
+
+int AiRequestDispatcher::min_cacheable_tokens(const QString& provider, const QString& model) {
+    if (provider == "Anthropic") return model.contains("haiku") ? 2048 : 1024;
+    if (provider == "OpenAI") return 1024;
+    return INT_MAX;
+}
+
+int AiRequestDispatcher::parse_retry_after(const QByteArray& header) {
+    if (header.isEmpty()) return 0;
+    bool ok = false;
+    int secs = header.trimmed().toInt(&ok);
+    if (ok) return std::max(secs, 1);
+    // HTTP-date form
+    QDateTime when = QDateTime::fromString(QString::fromLatin1(header).trimmed(), Qt::RFC2822Date);
+    if (!when.isValid()) return 0;
+    return std::max(1, static_cast<int>(QDateTime::currentDateTimeUtc().secsTo(when)));
+}
+
+void AiRequestDispatcher::record_response(const Lane& lane, const PendingRequest& request,
+                                          const QString& content, qint64 elapsed_ms) {
+    QFile file(record_path_);
+    if (!file.open(QIODevice::Append | QIODevice::Text)) {
+        LOG_WARN("AIMode", QString("Cannot write record file %1").arg(record_path_));
+        return;
+    }
+    QJsonObject entry;
+    entry["key"] = QString::fromLatin1(prompt_key(request.prefix + request.prompt));
+    entry["provider"] = lane.config.provider_name;
+    entry["model"] = lane.config.model_name;
+    entry["elapsed_ms"] = elapsed_ms;
+    entry["content"] = content;
+    file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact) + "\n");
+}
+
+QByteArray AiRequestDispatcher::prompt_key(const QString& full_prompt) {
+    return QCryptographicHash::hash(full_prompt.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+int AiRequestDispatcher::estimate_tokens(const QString& text) {
+    return static_cast<int>((text.size() + 3) / 4);
+}
+
+QNetworkRequest AiRequestDispatcher::build_request(const AiProviderConfig& config, const QString& cacheable_prefix,
+                                                   const QString& prompt, QByteArray& body_out) {
+    QUrl url(config.endpoint_url);
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    request.setTransferTimeout(config.is_local ? kLocalTimeoutMs : kCloudTimeoutMs);
+
+    // Set auth headers
+    if (!config.api_key.isEmpty()) {
+        if (config.provider_name == "Anthropic") {
+            request.setRawHeader("x-api-key", config.api_key.toUtf8());
+            request.setRawHeader("anthropic-version", "2023-06-01");
+        } else if (config.provider_name != "Google Gemini") {
+            request.setRawHeader("Authorization", QByteArray("Bearer ") + config.api_key.toUtf8());
+        }
+    }
+
+    QJsonObject body;
+    if (config.streaming) request.setRawHeader("Accept", "text/event-stream");
+
+    if (config.provider_name == "Anthropic") {
+        body["model"] = config.model_name;
+        body["max_tokens"] = AdaptiveBatcher::kResponseTokens;
+        if (config.streaming) body["stream"] = true;
+        if (!cacheable_prefix.isEmpty()) {
+            QJsonObject system_block;
+            system_block["type"] = "text";
+            system_block["text"] = cacheable_prefix;
+            // Explicit cache breakpoint; later batches read the prefix at a
+            // discount. Below the minimum the marker is ignored anyway.
+            if (estimate_tokens(cacheable_prefix) >= min_cacheable_tokens(config.provider_name, config.model_name)) {
+                system_block["cache_control"] = QJsonObject{{"type", "ephemeral"}};
+            }
+            body["system"] = QJsonArray{system_block};
+        }
+        QJsonArray messages;
+        QJsonObject msg;
+        msg["role"] = "user";
+        msg["content"] = prompt;
+        messages.append(msg);
+        body["messages"] = messages;
+    } else if (config.provider_name == "Google Gemini") {
+        // Gemini uses different URL/body structure
+        QString gemini_url = config.streaming
+            ? QString("%1/%2:streamGenerateContent?alt=sse&key=%3")
+                  .arg(config.endpoint_url, config.model_name, config.api_key)
+            : QString("%1/%2:generateContent?key=%3")
+                  .arg(config.endpoint_url, config.model_name, config.api_key);
+        request.setUrl(QUrl(gemini_url));
+
+        QJsonObject contents;
+        QJsonArray parts;
+        QJsonObject part;
+        part["text"] = cacheable_prefix + prompt;
+        parts.append(part);
+        contents["parts"] = parts;
+        QJsonArray contents_arr;
+        contents_arr.append(contents);
+        body["contents"] = contents_arr;
+    } else {
+        // OpenAI-compatible (OpenAI, Groq, OpenRouter, Mistral, Ollama, LM Studio)
+        body["model"] = config.model_name;
+        body["temperature"] = 0.3;
+        body["max_tokens"] = AdaptiveBatcher::kResponseTokens;
+        if (config.streaming) body["stream"] = true;
+        QJsonArray messages;
+        QJsonObject sys_msg;
+        sys_msg["role"] = "system";
+        sys_msg["content"] = QString("You are a file organization assistant. Respond only with the exact JSON array requested. No markdown formatting.");
+        messages.append(sys_msg);
+        // Shared prefix first: OpenAI caches identical leading tokens automatically
+        QJsonObject user_msg;
+        user_msg["role"] = "user";
+        user_msg["content"] = cacheable_prefix + prompt;
+        messages.append(user_msg);
+        body["messages"] = messages;
+    }
+
+    body_out = QJsonDocument(body).toJson(QJsonDocument::Compact);
+    return request;
+}
+
+QString AiRequestDispatcher::extract_content(const AiProviderConfig& config, const QByteArray& response) {
+    QJsonDocument doc = QJsonDocument::fromJson(response);
+    if (config.provider_name == "Anthropic") {
+        QJsonArray content_arr = doc.object()["content"].toArray();
+        if (!content_arr.isEmpty()) {
+            return content_arr[0].toObject()["text"].toString();
+        }
+    } else if (config.provider_name == "Google Gemini") {
+        QJsonArray candidates = doc.object()["candidates"].toArray();
+        if (!candidates.isEmpty()) {
+            QJsonArray parts = candidates[0].toObject()["content"].toObject()["parts"].toArray();
+            if (!parts.isEmpty()) {
+                return parts[0].toObject()["text"].toString();
+            }
+        }
+    } else {
+        QJsonArray choices = doc.object()["choices"].toArray();
+        if (!choices.isEmpty()) {
+            return choices[0].toObject()["message"].toObject()["content"].toString();
+        }
+    }
+    return QString();
+}
+
+QString AiRequestDispatcher::extract_stream_delta(const AiProviderConfig& config, const QJsonObject& event) {
+    if (config.provider_name == "Anthropic") {
+        // Only content_block_delta events carry text
+        if (event["type"].toString() != "content_block_delta") return QString();
+        return event["delta"].toObject()["text"].toString();
+    }
+    if (config.provider_name == "Google Gemini") {
+        // Each event is a full GenerateContentResponse holding the next chunk
+        QJsonArray candidates = event["candidates"].toArray();
+        if (candidates.isEmpty()) return QString();
+        QJsonArray parts = candidates[0].toObject()["content"].toObject()["parts"].toArray();
+        QString text;
+        for (const QJsonValue& part : parts) text += part.toObject()["text"].toString();
+        return text;
+    }
+    QJsonArray choices = event["choices"].toArray();
+    if (choices.isEmpty()) return QString();
+    return choices[0].toObject()["delta"].toObject()["content"].toString();
+}
@@ -0,0 +1,277 @@
+#include "ArchiveInspector.hpp"
+#include "ZipDirectory.hpp"
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+
+#ifdef FILETINDER_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+    constexpr int kTarBlock = 512;
+    constexpr int kMaxTopLevelTracked = 1000;
+    constexpr quint64 kMaxLongNameBytes = 64 * 1024;
+
+    // Sequential source of tar blocks: a plain file or a gzip stream
+    class TarSource {
+    public:
+        virtual ~TarSource() = default;
+        virtual bool read(char* out, qint64 length) = 0;
+        virtual bool skip(quint64 length) = 0;
+        virtual bool over_budget() const { return false; }
+    };
+
+    class PlainTarSource : public TarSource {
+    public:
+        explicit PlainTarSource(QFile& file) : file_(file) {}
+        bool read(char* out, qint64 length) override { return file_.read(out, length) == length; }
+        bool skip(quint64 length) override {
+            qint64 target = file_.pos() + static_cast<qint64>(length);
+            return target <= file_.size() && file_.seek(target);
+        }
+    private:
+        QFile& file_;
+    };
+
+#ifdef FILETINDER_HAS_ZLIB
+    // Gzip has no index, so skipping means inflating and discarding;
+    // the budget bounds how much of a huge .tar.gz we are willing to touch
+    class GzipTarSource : public TarSource {
+    public:
+        GzipTarSource(QFile& file, qint64 budget) : file_(file), budget_(budget) {
+            // 16 + MAX_WBITS: expect a gzip header
+            ok_ = inflateInit2(&stream_, 16 + MAX_WBITS) == Z_OK;
+        }
+        ~GzipTarSource() override {
+            if (ok_) inflateEnd(&stream_);
+        }
+        bool read(char* out, qint64 length) override {
+            if (!ok_) return false;
+            stream_.next_out = reinterpret_cast<Bytef*>(out);
+            stream_.avail_out = static_cast<uInt>(length);
+            while (stream_.avail_out > 0) {
+                if (stream_.avail_in == 0) {
+                    qint64 got = file_.read(input_, sizeof(input_));
+                    if (got <= 0) return false;
+                    stream_.next_in = reinterpret_cast<Bytef*>(input_);
+                    stream_.avail_in = static_cast<uInt>(got);
+                }
+                int rc = inflate(&stream_, Z_NO_FLUSH);
+                if (rc == Z_STREAM_END) return stream_.avail_out == 0;
+                if (rc != Z_OK) return false;
+            }
+            return true;
+        }
+        bool skip(quint64 length) override {
+            char scratch[16 * 1024];
+            while (length > 0) {
+                if (over_budget()) return false;
+                qint64 chunk = static_cast<qint64>(std::min<quint64>(length, sizeof(scratch)));
+                if (!read(scratch, chunk)) return false;
+                length -= static_cast<quint64>(chunk);
+            }
+            return true;
+        }
+        bool over_budget() const override { return static_cast<qint64>(stream_.total_out) > budget_; }
+    private:
+        QFile& file_;
+        qint64 budget_;
+        z_stream stream_{};
+        char input_[64 * 1024];
+        bool ok_ = false;
+    };
+#endif
+
+    quint64 parse_tar_number(const char* field, int length) {
+        // GNU base-256 encoding for values that overflow the octal field
+        if (static_cast<unsigned char>(field[0]) & 0x80) {
+            quint64 value = static_cast<unsigned char>(field[0]) & 0x7F;
+            for (int i = 1; i < length; ++i) value = (value << 8) | static_cast<unsigned char>(field[i]);
+            return value;
+        }
+        quint64 value = 0;
+        for (int i = 0; i < length && field[i]; ++i) {
+            if (field[i] >= '0' && field[i] <= '7') value = value * 8 + static_cast<quint64>(field[i] - '0');
+        }
+        return value;
+    }
+
+    bool tar_checksum_ok(const char* header) {
+        quint64 expected = parse_tar_number(header + 148, 8);
+        quint64 sum = 0;
+        for (int i = 0; i < kTarBlock; ++i) {
+            sum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(header[i]);
+        }
+        return sum == expected;
+    }
+
+    QString tar_field(const char* field, int length) {
+        return QString::fromUtf8(field, static_cast<int>(strnlen(field, static_cast<size_t>(length))));
+    }
+}
+
+bool ArchiveInspector::can_inspect(const QString& file_path) {
+    QString name = QFileInfo(file_path).fileName().toLower();
+    if (name.endsWith(".zip") || name.endsWith(".jar") || name.endsWith(".tar")) return true;
+#ifdef FILETINDER_HAS_ZLIB
+    if (name.endsWith(".tar.gz") || name.endsWith(".tgz")) return true;
+#endif
+    return false;
+}
+
+ArchiveSummary ArchiveInspector::inspect(const QString& file_path) {
+    QString name = QFileInfo(file_path).fileName().toLower();
+    if (name.endsWith(".tar")) return inspect_tar(file_path);
+    if (name.endsWith(".tar.gz") || name.endsWith(".tgz")) return inspect_tar_gz(file_path);
+    return inspect_zip(file_path);
+}
+
+ArchiveSummary ArchiveInspector::inspect_zip(const QString& file_path) {
+    ArchiveSummary summary;
+    summary.format = "ZIP";
+    ZipDirectory zip;
+    if (!zip.open(file_path)) return summary;
+
+    summary.valid = true;
+    for (const ZipEntry& entry : zip.entries()) {
+        add_entry(summary, entry.name, entry.uncompressed_size);
+    }
+    summary.partial = zip.truncated();
+    // Trust the EOCD count when the directory listing was cut short
+    if (zip.declared_entry_count() > static_cast<quint64>(summary.entry_count)) {
+        summary.entry_count = static_cast<int>(std::min<quint64>(zip.declared_entry_count(), INT_MAX));
+    }
+    return summary;
+}
+
+// Shared header walk for plain and gzipped tar
+static void walk_tar(TarSource& source, ArchiveSummary& summary, int max_entries,
+                     void (*add)(ArchiveSummary&, const QString&, quint64)) {
+    char header[kTarBlock];
+    QString override_name;
+    int zero_blocks = 0;
+
+    while (summary.entry_count < max_entries) {
+        if (source.over_budget() || !source.read(header, kTarBlock)) {
+            summary.partial = summary.valid;
+            return;
+        }
+        if (std::all_of(header, header + kTarBlock, [](char c) { return c == 0; })) {
+            if (++zero_blocks == 2) return;  // End-of-archive marker
+            continue;
+        }
+        zero_blocks = 0;
+        if (!tar_checksum_ok(header)) {
+            summary.partial = summary.valid;
+            return;
+        }
+        summary.valid = true;
+
+        quint64 size = parse_tar_number(header + 124, 12);
+        quint64 padded = (size + kTarBlock - 1) & ~static_cast<quint64>(kTarBlock - 1);
+        char type = header[156];
+
+        // GNU long name ('L') and pax headers ('x') carry the next entry's path
+        if (type == 'L' || type == 'x') {
+            if (size > kMaxLongNameBytes) {
+                if (!source.skip(padded)) return;
+                continue;
+            }
+            QByteArray data(static_cast<qsizetype>(padded), '\0');
+            if (!source.read(data.data(), static_cast<qint64>(padded))) return;
+            data.truncate(static_cast<qsizetype>(size));
+            if (type == 'L') {
+                override_name = QString::fromUtf8(data.constData(), static_cast<int>(strnlen(data.constData(), static_cast<size_t>(data.size()))));
+            } else {
+                // pax records: "<len> key=value\n"
+                for (const QByteArray& record : data.split('\n')) {
+                    int key_pos = record.indexOf(" path=");
+                    if (key_pos >= 0) override_name = QString::fromUtf8(record.mid(key_pos + 6));
+                }
+            }
+            continue;
+        }
+        if (type == 'g') {  // pax global header, not an entry
+            if (!source.skip(padded)) return;
+            continue;
+        }
+
+        QString name = override_name;
+        override_name.clear();
+        if (name.isEmpty()) {
+            name = tar_field(header, 100);
+            QString prefix = std::memcmp(header + 257, "ustar", 5) == 0 ? tar_field(header + 345, 155) : QString();
+            if (!prefix.isEmpty()) name = prefix + "/" + name;
+        }
+        bool is_file = (type == '0' || type == '\0' || type == '7');
+        add(summary, name, is_file ? size : 0);
+
+        // Only regular files carry data blocks worth skipping
+        if (is_file && padded > 0 && !source.skip(padded)) {
+            summary.partial = true;
+            return;
+        }
+    }
+    summary.partial = true;
+}
+
+ArchiveSummary ArchiveInspector::inspect_tar(const QString& file_path) {
+    ArchiveSummary summary;
+    summary.format = "TAR";
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) return summary;
+    PlainTarSource source(file);
+    walk_tar(source, summary, kMaxTarEntries, &ArchiveInspector::add_entry);
+    return summary;
+}
+
+ArchiveSummary ArchiveInspector::inspect_tar_gz(const QString& file_path) {
+    ArchiveSummary summary;
+    summary.format = "TAR.GZ";
+#ifdef FILETINDER_HAS_ZLIB
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) return summary;
+    auto source = std::make_unique<GzipTarSource>(file, kMaxGzipInflateBytes);
+    walk_tar(*source, summary, kMaxTarEntries, &ArchiveInspector::add_entry);
+#else
+    Q_UNUSED(file_path);
+#endif
+    return summary;
+}
+
+void ArchiveInspector::add_entry(ArchiveSummary& summary, const QString& name, quint64 size) {
+    ++summary.entry_count;
+    summary.total_uncompressed += size;
+
+    QString path = name;
+    while (path.startsWith("./")) path.remove(0, 2);
+    QString top = path.section('/', 0, 0);
+    if (path.contains('/')) top += "/";
+    if (!top.isEmpty() && summary.top_level.size() < kMaxTopLevelTracked && !summary.top_level.contains(top)) {
+        summary.top_level.append(top);
+    }
+}
+
+QString ArchiveInspector::format_for_display(const ArchiveSummary& summary) {
+    if (!summary.valid) {
+        return QString("%1 archive\n\nCould not read archive contents").arg(summary.format);
+    }
+    QLocale locale;
+    QString more = summary.partial ? "+" : "";
+    QString text = QString("%1 archive\n%2%3 entries, %4%5 uncompressed\n\n")
+                       .arg(summary.format)
+                       .arg(summary.entry_count).arg(more)
+                       .arg(locale.formattedDataSize(static_cast<qint64>(summary.total_uncompressed))).arg(more);
+
+    QStringList shown = summary.top_level.mid(0, kTopLevelShown);
+    text += shown.join("\n");
+    int hidden = static_cast<int>(summary.top_level.size()) - static_cast<int>(shown.size());
+    if (hidden > 0) text += QString("\n... and %1 more").arg(hidden);
+    if (summary.partial) text += "\n\n(partial listing — archive is very large)";
+    return text;
+}
@@ -0,0 +1,259 @@
+#include "ContentHintExtractor.hpp"
+#include "TextPreviewLoader.hpp"
+#include "ZipDirectory.hpp"
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QStringDecoder>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    quint16 read_u16(const uchar* p, bool little_endian) {
+        return little_endian ? static_cast<quint16>(p[0] | (p[1] << 8))
+                             : static_cast<quint16>((p[0] << 8) | p[1]);
+    }
+
+    quint32 read_u32(const uchar* p, bool little_endian) {
+        return little_endian
+            ? static_cast<quint32>(p[0]) | (static_cast<quint32>(p[1]) << 8) | (static_cast<quint32>(p[2]) << 16) | (static_cast<quint32>(p[3]) << 24)
+            : (static_cast<quint32>(p[0]) << 24) | (static_cast<quint32>(p[1]) << 16) | (static_cast<quint32>(p[2]) << 8) | static_cast<quint32>(p[3]);
+    }
+
+    quint32 syncsafe(const uchar* p) {
+        return (static_cast<quint32>(p[0] & 0x7F) << 21) | (static_cast<quint32>(p[1] & 0x7F) << 14)
+             | (static_cast<quint32>(p[2] & 0x7F) << 7) | static_cast<quint32>(p[3] & 0x7F);
+    }
+
+    // Text payload of an ID3v2 T*** frame; first byte is the encoding
+    QString decode_id3_text(const QByteArray& data) {
+        if (data.isEmpty()) return QString();
+        QByteArray body = data.mid(1);
+        switch (data[0]) {
+            case 1: return QStringDecoder(QStringDecoder::Utf16).decode(body);    // With BOM
+            case 2: return QStringDecoder(QStringDecoder::Utf16BE).decode(body);
+            case 3: return QString::fromUtf8(body);
+            default: return QString::fromLatin1(body);
+        }
+    }
+
+    // PDF literal string starting after '(' with escapes and nesting;
+    // UTF-16BE when it begins with a byte order mark
+    QString decode_pdf_literal(const QByteArray& data, int start) {
+        QByteArray out;
+        int depth = 1;
+        for (int i = start; i < data.size() && out.size() < 512; ++i) {
+            char c = data[i];
+            if (c == '\\' && i + 1 < data.size()) {
+                char n = data[++i];
+                if (n >= '0' && n <= '7') {
+                    int value = 0, digits = 0;
+                    while (digits < 3 && i < data.size() && data[i] >= '0' && data[i] <= '7') {
+                        value = value * 8 + (data[i] - '0');
+                        ++i;
+                        ++digits;
+                    }
+                    --i;
+                    out += static_cast<char>(value);
+                } else if (n == 'n') out += '\n';
+                else if (n == 'r') out += '\r';
+                else if (n == 't') out += '\t';
+                else out += n;
+                continue;
+            }
+            if (c == '(') ++depth;
+            if (c == ')' && --depth == 0) break;
+            out += c;
+        }
+        if (out.startsWith("\xFE\xFF")) return QStringDecoder(QStringDecoder::Utf16BE).decode(out.mid(2));
+        return QString::fromLatin1(out);
+    }
+}
+
+QString ContentHintExtractor::extract(const QString& file_path, const QString& mime_type) {
+    QString suffix = QFileInfo(file_path).suffix().toLower();
+    QString hint;
+    if (mime_type == "application/pdf" || suffix == "pdf") {
+        hint = pdf_hint(file_path);
+    } else if (mime_type == "image/jpeg") {
+        hint = exif_hint(file_path);
+    } else if (mime_type.startsWith("audio/") && (suffix == "mp3" || mime_type == "audio/mpeg")) {
+        hint = id3_hint(file_path);
+    } else if (QStringList{"docx", "xlsx", "pptx", "odt", "ods", "odp"}.contains(suffix)) {
+        hint = office_hint(file_path);
+    } else if (mime_type.startsWith("text/") || mime_type.contains("json") || mime_type.contains("xml")) {
+        hint = text_hint(file_path);
+    }
+    return clean(hint);
+}
+
+QString ContentHintExtractor::clean(const QString& hint) {
+    // One line, no field separator, bounded
+    QString text = hint;
+    text.replace('|', '/');
+    text = text.simplified();
+    if (text.size() > kMaxHintChars) text = text.left(kMaxHintChars - 3) + "...";
+    return text;
+}
+
+QString ContentHintExtractor::pdf_hint(const QString& file_path) {
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+    // The info dictionary sits near the start (linearized) or near the end
+    QByteArray data = file.read(kScanBytes);
+    if (file.size() > kScanBytes) {
+        file.seek(std::max<qint64>(kScanBytes, file.size() - kScanBytes));
+        data += file.read(kScanBytes);
+    }
+
+    QStringList parts;
+    for (const char* key : {"/Title", "/Author", "/Subject"}) {
+        int pos = data.indexOf(key);
+        if (pos < 0) continue;
+        int open = pos + static_cast<int>(qstrlen(key));
+        while (open < data.size() && (data[open] == ' ' || data[open] == '\r' || data[open] == '\n')) ++open;
+        if (open >= data.size() || data[open] != '(') continue;
+        QString value = decode_pdf_literal(data, open + 1).trimmed();
+        if (!value.isEmpty()) parts.append(QString("%1: %2").arg(QString::fromLatin1(key + 1).toLower(), value));
+    }
+    return parts.join("; ");
+}
+
+QString ContentHintExtractor::office_hint(const QString& file_path) {
+    ZipDirectory zip;
+    if (!zip.open(file_path)) return QString();
+    const ZipEntry* entry = zip.find("docProps/core.xml");
+    if (!entry) entry = zip.find("meta.xml");
+    if (!entry) return QString();
+    QString xml = QString::fromUtf8(zip.read_entry(*entry, kScanBytes));
+
+    QStringList parts;
+    static const QRegularExpression title_re("<dc:title>([^<]*)</dc:title>");
+    static const QRegularExpression subject_re("<dc:subject>([^<]*)</dc:subject>");
+    static const QRegularExpression keywords_re("<(?:cp|meta):keywords?>([^<]*)</(?:cp|meta):keywords?>");
+    auto add = [&](const QRegularExpression& re, const QString& label) {
+        QString value = re.match(xml).captured(1).trimmed();
+        if (!value.isEmpty()) parts.append(label + ": " + value);
+    };
+    add(title_re, "title");
+    add(subject_re, "subject");
+    add(keywords_re, "keywords");
+    return parts.join("; ");
+}
+
+QString ContentHintExtractor::exif_hint(const QString& file_path) {
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+    QByteArray data = file.read(kScanBytes);
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    const qsizetype size = data.size();
+    if (size < 4 || p[0] != 0xFF || p[1] != 0xD8) return QString();
+
+    // Walk JPEG markers to APP1 "Exif\0\0"
+    qsizetype pos = 2;
+    qsizetype tiff = -1, tiff_end = 0;
+    while (pos + 4 <= size && p[pos] == 0xFF) {
+        uchar marker = p[pos + 1];
+        qsizetype length = (p[pos + 2] << 8) | p[pos + 3];
+        if (marker == 0xE1 && pos + 10 <= size && std::memcmp(p + pos + 4, "Exif\0\0", 6) == 0) {
+            tiff = pos + 10;
+            tiff_end = std::min(size, pos + 2 + length);
+            break;
+        }
+        if (marker == 0xDA) break;  // Image data starts; no Exif
+        pos += 2 + length;
+    }
+    if (tiff < 0 || tiff + 8 > tiff_end) return QString();
+
+    bool le = p[tiff] == 'I';
+    // Offset of the 12-byte entry for `wanted` in the IFD at `ifd`, or -1
+    auto find_entry = [&](quint32 ifd, quint16 wanted) -> qint64 {
+        qint64 base = tiff + static_cast<qint64>(ifd);
+        if (base + 2 > tiff_end) return -1;
+        quint16 count = read_u16(p + base, le);
+        for (quint16 i = 0; i < count; ++i) {
+            qint64 e = base + 2 + static_cast<qint64>(i) * 12;
+            if (e + 12 > tiff_end) break;
+            if (read_u16(p + e, le) == wanted) return e;
+        }
+        return -1;
+    };
+    auto ascii_tag = [&](quint32 ifd, quint16 wanted) -> QString {
+        qint64 e = find_entry(ifd, wanted);
+        if (e < 0) return QString();
+        quint32 n = read_u32(p + e + 4, le);
+        qint64 value = n <= 4 ? e + 8 : tiff + static_cast<qint64>(read_u32(p + e + 8, le));
+        if (value + static_cast<qint64>(n) > tiff_end) return QString();
+        const char* text = reinterpret_cast<const char*>(p + value);
+        return QString::fromLatin1(text, static_cast<int>(qstrnlen(text, n))).trimmed();
+    };
+    auto long_tag = [&](quint32 ifd, quint16 wanted) -> quint32 {
+        qint64 e = find_entry(ifd, wanted);
+        return e < 0 ? 0 : read_u32(p + e + 8, le);
+    };
+
+    quint32 ifd0 = read_u32(p + tiff + 4, le);
+    QString make = ascii_tag(ifd0, 0x010F);
+    QString model = ascii_tag(ifd0, 0x0110);
+    QString date;
+    if (quint32 exif_ifd = long_tag(ifd0, 0x8769)) date = ascii_tag(exif_ifd, 0x9003);  // DateTimeOriginal
+    if (date.isEmpty()) date = ascii_tag(ifd0, 0x0132);
+
+    QStringList parts;
+    if (!date.isEmpty()) parts.append("taken " + date.left(10).replace(':', '-'));
+    // Model usually repeats the make ("Canon EOS 80D")
+    QString camera = model.startsWith(make.section(' ', 0, 0), Qt::CaseInsensitive) ? model : (make + " " + model).trimmed();
+    if (!camera.isEmpty()) parts.append("camera " + camera);
+    return parts.join("; ");
+}
+
+QString ContentHintExtractor::id3_hint(const QString& file_path) {
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+    QByteArray head = file.read(kScanBytes);
+    const uchar* p = reinterpret_cast<const uchar*>(head.constData());
+
+    QString title, artist, album;
+    if (head.size() >= 10 && head.startsWith("ID3")) {
+        int version = p[3];
+        qsizetype end = std::min<qsizetype>(head.size(), 10 + syncsafe(p + 6));
+        qsizetype pos = 10;
+        if (p[5] & 0x40 && pos + 4 <= end) {  // Extended header
+            pos += version >= 4 ? syncsafe(p + pos) : read_u32(p + pos, false) + 4;
+        }
+        while (pos + 10 <= end && p[pos] != 0) {
+            QByteArray id = head.mid(pos, 4);
+            quint32 frame_size = version >= 4 ? syncsafe(p + pos + 4) : read_u32(p + pos + 4, false);
+            qsizetype data_start = pos + 10;
+            if (frame_size == 0 || data_start + frame_size > end) break;
+            QByteArray data = head.mid(data_start, frame_size);
+            if (id == "TIT2") title = decode_id3_text(data);
+            else if (id == "TPE1") artist = decode_id3_text(data);
+            else if (id == "TALB") album = decode_id3_text(data);
+            pos = data_start + frame_size;
+        }
+    }
+    // ID3v1 trailer as a fallback
+    if (title.isEmpty() && artist.isEmpty() && file.size() >= 128 && file.seek(file.size() - 128)) {
+        QByteArray tag = file.read(128);
+        if (tag.startsWith("TAG")) {
+            title = QString::fromLatin1(tag.mid(3, 30)).remove(QChar('\0')).trimmed();
+            artist = QString::fromLatin1(tag.mid(33, 30)).remove(QChar('\0')).trimmed();
+            album = QString::fromLatin1(tag.mid(63, 30)).remove(QChar('\0')).trimmed();
+        }
+    }
+
+    title.remove(QChar('\0'));
+    artist.remove(QChar('\0'));
+    album.remove(QChar('\0'));
+    QString hint = artist.isEmpty() ? title : (title.isEmpty() ? artist : artist + " - " + title);
+    if (!album.isEmpty()) hint += QString(" (%1)").arg(album);
+    return hint.trimmed();
+}
+
+QString ContentHintExtractor::text_hint(const QString& file_path) {
+    TextPreview preview = TextPreviewLoader::load(file_path);
+    if (preview.is_binary) return QString();
+    return "starts: " + preview.text.left(kMaxHintChars * 2).simplified();
+}
@@ -114,6 +114,18 @@ bool DatabaseManager::create_tables() {
         )
     )";
     
+    // AI classification cache
+    queries << R"(
+        CREATE TABLE IF NOT EXISTS ai_classification_cache (
+            config_key TEXT NOT NULL,
+            fingerprint TEXT NOT NULL,
+            result_json TEXT NOT NULL,
+            last_used DATETIME DEFAULT CURRENT_TIMESTAMP,
+            PRIMARY KEY (config_key, fingerprint)
+        )
+    )";
+    queries << "CREATE INDEX IF NOT EXISTS idx_ai_cache_last_used ON ai_classification_cache(last_used)";
+    
     for (const QString& query : queries) {
         if (!execute_query(query)) {
             return false;
@@ -153,6 +165,57 @@ bool DatabaseManager::save_file_decision(const QString& session_folder, const QS
     return true;
 }
 
+bool DatabaseManager::save_file_decisions(const QString& session_folder, const std::vector<FileDecision>& decisions) {
+    if (decisions.empty()) return true;
+
+    db_.transaction();
+    QSqlQuery query(db_);
+    query.prepare(R"(
+        INSERT OR REPLACE INTO file_tinder_state 
+        (folder_path, file_path, decision, destination_folder, timestamp)
+        VALUES (?, ?, ?, ?, datetime('now'))
+    )");
+    for (const auto& decision : decisions) {
+        query.addBindValue(session_folder);
+        query.addBindValue(decision.file_path);
+        query.addBindValue(decision.decision);
+        query.addBindValue(decision.destination_folder);
+        if (!query.exec()) {
+            qWarning() << "Failed to save file decisions:" << query.lastError().text();
+            db_.rollback();
+            return false;
+        }
+    }
+    return db_.commit();
+}
+
+std::vector<FileDecision> DatabaseManager::get_recent_move_decisions(int limit) {
+    std::vector<FileDecision> decisions;
+    
+    QSqlQuery query(db_);
+    query.prepare(R"(
+        SELECT file_path, decision, destination_folder, timestamp
+        FROM file_tinder_state
+        WHERE decision = 'move' AND destination_folder IS NOT NULL AND destination_folder != ''
+        ORDER BY timestamp DESC
+        LIMIT ?
+    )");
+    query.addBindValue(limit);
+    
+    if (query.exec()) {
+        while (query.next()) {
+            FileDecision fd;
+            fd.file_path = query.value(0).toString();
+            fd.decision = query.value(1).toString();
+            fd.destination_folder = query.value(2).toString();
+            fd.timestamp = query.value(3).toLongLong();
+            decisions.push_back(fd);
+        }
+    }
+    
+    return decisions;
+}
+
 std::vector<FileDecision> DatabaseManager::get_session_decisions(const QString& session_folder) {
     std::vector<FileDecision> decisions;
     
@@ -615,6 +678,63 @@ QStringList DatabaseManager::get_ai_provider_names() {
     return names;
 }
 
+QHash<QString, QString> DatabaseManager::get_ai_classifications(const QString& config_key,
+                                                                const QStringList& fingerprints) {
+    QHash<QString, QString> results;
+    if (fingerprints.isEmpty()) return results;
+
+    db_.transaction();
+    QSqlQuery q(db_);
+    q.prepare("SELECT result_json FROM ai_classification_cache WHERE config_key = ? AND fingerprint = ?");
+    QSqlQuery touch(db_);
+    touch.prepare("UPDATE ai_classification_cache SET last_used = datetime('now') WHERE config_key = ? AND fingerprint = ?");
+    for (const QString& fingerprint : fingerprints) {
+        q.addBindValue(config_key);
+        q.addBindValue(fingerprint);
+        if (q.exec() && q.next()) {
+            results.insert(fingerprint, q.value(0).toString());
+            touch.addBindValue(config_key);
+            touch.addBindValue(fingerprint);
+            touch.exec();
+        }
+        q.finish();
+    }
+    db_.commit();
+    return results;
+}
+
+bool DatabaseManager::save_ai_classifications(const QString& config_key,
+                                              const QHash<QString, QString>& results_by_fingerprint) {
+    if (results_by_fingerprint.isEmpty()) return true;
+
+    db_.transaction();
+    QSqlQuery q(db_);
+    q.prepare(R"(
+        INSERT OR REPLACE INTO ai_classification_cache
+        (config_key, fingerprint, result_json, last_used)
+        VALUES (?, ?, ?, datetime('now'))
+    )");
+    for (auto it = results_by_fingerprint.constBegin(); it != results_by_fingerprint.constEnd(); ++it) {
+        q.addBindValue(config_key);
+        q.addBindValue(it.key());
+        q.addBindValue(it.value());
+        if (!q.exec()) {
+            qWarning() << "Failed to cache AI classification:" << q.lastError().text();
+            db_.rollback();
+            return false;
+        }
+    }
+    return db_.commit();
+}
+
+int DatabaseManager::prune_ai_classifications(int days_unused) {
+    QSqlQuery q(db_);
+    q.prepare("DELETE FROM ai_classification_cache WHERE last_used < datetime('now', ?)");
+    q.addBindValue(QString("-%1 days").arg(days_unused));
+    if (!q.exec()) return 0;
+    return q.numRowsAffected();
+}
+
 int DatabaseManager::cleanup_stale_sessions(int days_old) {
     int cleaned = 0;
     
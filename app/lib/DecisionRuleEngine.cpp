@@ -0,0 +1,110 @@
+#include "DecisionRuleEngine.hpp"
+#include "FileSearchIndex.hpp"
+#include "StandaloneFileTinderDialog.hpp"
+#include <QSettings>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+
+bool DecisionRuleEngine::set_rules(const std::vector<DecisionRule>& rules, QString* error) {
+    std::vector<FileQuery> queries;
+    queries.reserve(rules.size());
+    for (size_t r = 0; r < rules.size(); ++r) {
+        const DecisionRule& rule = rules[r];
+        FileQuery query = FileQuery::compile(rule.query);
+        if (rule.enabled) {
+            QString problem;
+            if (!query.is_valid()) problem = query.error();
+            else if (query.is_empty()) problem = "empty query would match every file";
+            else if (rule.action == "move" && rule.destination.trimmed().isEmpty()) problem = "move needs a destination";
+            if (!problem.isEmpty()) {
+                if (error) *error = QString("Rule %1: %2").arg(r + 1).arg(problem);
+                return false;
+            }
+        }
+        queries.push_back(query);
+    }
+    rules_ = rules;
+    queries_ = std::move(queries);
+    return true;
+}
+
+RuleMatchResult DecisionRuleEngine::match(const std::vector<FileToProcess>& files, const FileQuery::Columns& columns,
+                                          const FileSearchIndex* index) const {
+    QElapsedTimer timer;
+    timer.start();
+
+    RuleMatchResult result;
+    const int count = static_cast<int>(files.size());
+    result.rule_for_file.assign(count, -1);
+    result.per_rule.assign(rules_.size(), 0);
+    if (count == 0 || rules_.empty()) return result;
+
+    // One chunk per core; name lookups in the index are repeated per chunk,
+    // so more, smaller chunks would only add work
+    int chunk = std::max(kMinChunkFiles, (count + QThread::idealThreadCount() - 1) / std::max(1, QThread::idealThreadCount()));
+    std::vector<int> starts;
+    for (int begin = 0; begin < count; begin += chunk) starts.push_back(begin);
+
+    int* claimed = result.rule_for_file.data();
+    QtConcurrent::blockingMap(starts, [&](const int& begin) {
+        int end = std::min(count, begin + chunk);
+        std::vector<quint8> open(end - begin);
+        int remaining = 0;
+        for (int i = begin; i < end; ++i) {
+            open[i - begin] = files[i].decision == "pending" ? 1 : 0;
+            remaining += open[i - begin];
+        }
+        for (size_t r = 0; r < rules_.size() && remaining > 0; ++r) {
+            if (!rules_[r].enabled) continue;
+            std::vector<quint8> hits = queries_[r].evaluate(files, columns, index, begin, end);
+            for (int i = 0; i < end - begin; ++i) {
+                if (open[i] && hits[i]) {
+                    claimed[begin + i] = static_cast<int>(r);
+                    open[i] = 0;
+                    --remaining;
+                }
+            }
+        }
+    });
+
+    for (int r : result.rule_for_file) {
+        if (r < 0) continue;
+        result.per_rule[r]++;
+        result.matched++;
+    }
+    result.elapsed_ms = timer.elapsed();
+    return result;
+}
+
+std::vector<DecisionRule> DecisionRuleEngine::load_rules() {
+    QSettings settings("FileTinder", "FileTinder");
+    std::vector<DecisionRule> rules;
+    int size = settings.beginReadArray("rules/decisionRules");
+    for (int i = 0; i < size; ++i) {
+        settings.setArrayIndex(i);
+        DecisionRule rule;
+        rule.query = settings.value("query").toString();
+        rule.action = settings.value("action", "keep").toString();
+        rule.destination = settings.value("destination").toString();
+        rule.enabled = settings.value("enabled", true).toBool();
+        rules.push_back(rule);
+    }
+    settings.endArray();
+    return rules;
+}
+
+void DecisionRuleEngine::save_rules(const std::vector<DecisionRule>& rules) {
+    QSettings settings("FileTinder", "FileTinder");
+    settings.remove("rules/decisionRules");
+    settings.beginWriteArray("rules/decisionRules", static_cast<int>(rules.size()));
+    for (int i = 0; i < static_cast<int>(rules.size()); ++i) {
+        settings.setArrayIndex(i);
+        settings.setValue("query", rules[i].query);
+        settings.setValue("action", rules[i].action);
+        settings.setValue("destination", rules[i].destination);
+        settings.setValue("enabled", rules[i].enabled);
+    }
+    settings.endArray();
+}
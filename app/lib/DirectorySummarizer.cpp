@@ -0,0 +1,87 @@
+#include "DirectorySummarizer.hpp"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QLocale>
+#include <algorithm>
+
+DirectorySummary DirectorySummarizer::summarize(const QString& dir_path) {
+    DirectorySummary summary;
+    QString root = QDir(dir_path).absolutePath();
+    QHash<QString, int> type_counts;
+    QElapsedTimer timer;
+    timer.start();
+
+    int visited = 0;
+    QDirIterator it(root, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        bool direct_child = (info.absolutePath() == root);
+
+        if (info.isDir()) {
+            if (direct_child) ++summary.dir_count;
+        } else {
+            if (direct_child) ++summary.file_count;
+            ++summary.total_files;
+            summary.total_size += info.size();
+            QString ext = info.suffix().toLower();
+            ++type_counts[ext.isEmpty() ? QString("(none)") : ext];
+        }
+        QDateTime mtime = info.lastModified();
+        if (!summary.newest_mtime.isValid() || mtime > summary.newest_mtime) {
+            summary.newest_mtime = mtime;
+        }
+
+        // Check the clock every 256 entries; it's cheap but not free
+        if (++visited >= kMaxEntries || ((visited & 0xFF) == 0 && timer.elapsed() > kMaxWalkMs)) {
+            summary.partial = true;
+            break;
+        }
+    }
+
+    for (auto type = type_counts.cbegin(); type != type_counts.cend(); ++type) {
+        summary.top_types.append({type.key(), type.value()});
+    }
+    std::sort(summary.top_types.begin(), summary.top_types.end(),
+              [](const QPair<QString, int>& a, const QPair<QString, int>& b) { return a.second > b.second; });
+    if (summary.top_types.size() > kTopTypes) {
+        summary.top_types = summary.top_types.mid(0, kTopTypes);
+    }
+    return summary;
+}
+
+QString DirectorySummarizer::format_for_display(const DirectorySummary& summary) {
+    QLocale locale;
+    QString prefix = summary.partial ? "at least " : "";
+    QString text = QString("Directory contains:\n%1 files\n%2 subdirectories\n\n")
+                       .arg(summary.file_count).arg(summary.dir_count);
+    text += QString("Total: %1%2 files, %3\n")
+                .arg(prefix)
+                .arg(summary.total_files)
+                .arg(locale.formattedDataSize(summary.total_size));
+    if (summary.newest_mtime.isValid()) {
+        text += QString("Newest change: %1\n").arg(summary.newest_mtime.toString("yyyy-MM-dd hh:mm"));
+    }
+    if (!summary.top_types.isEmpty()) {
+        QStringList types;
+        for (const auto& type : summary.top_types) {
+            types.append(QString("%1 (%2)").arg(type.first).arg(type.second));
+        }
+        text += QString("Top types: %1").arg(types.join(", "));
+    }
+    if (summary.partial) text += "\n\n(partial scan — folder is very large)";
+    return text;
+}
+
+QString DirectorySummarizer::format_brief(const DirectorySummary& summary) {
+    QLocale locale;
+    return QString("%1%2 files | %3 | %4 subfolders")
+        .arg(summary.partial ? ">" : "")
+        .arg(summary.total_files)
+        .arg(locale.formattedDataSize(summary.total_size))
+        .arg(summary.dir_count);
+}
@@ -0,0 +1,133 @@
+#include "DocumentThumbnailer.hpp"
+#include "ZipDirectory.hpp"
+#include "AppLogger.hpp"
+#include <QFileInfo>
+#include <QStringList>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QFile>
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#ifdef FILETINDER_HAS_QT_PDF
+#include <QPdfDocument>
+#endif
+
+namespace {
+    const QStringList kOfficeSuffixes = {
+        "docx", "docm", "xlsx", "xlsm", "pptx", "pptm",
+        "odt", "ods", "odp", "odg"
+    };
+    // Where Office and LibreOffice store their preview images
+    const QStringList kThumbnailEntries = {
+        "docProps/thumbnail.jpeg", "docProps/thumbnail.jpg", "docProps/thumbnail.png",
+        "Thumbnails/thumbnail.png"
+    };
+}
+
+bool DocumentThumbnailer::can_render(const QString& file_path, const QString& mime_type) {
+#ifdef FILETINDER_HAS_QT_PDF
+    if (is_pdf(file_path, mime_type)) return true;
+#endif
+    return kOfficeSuffixes.contains(QFileInfo(file_path).suffix().toLower());
+}
+
+QImage DocumentThumbnailer::render(const QString& file_path, const QString& mime_type, const QSize& max_size) {
+    if (is_pdf(file_path, mime_type)) return render_pdf(file_path, max_size);
+    return extract_embedded_thumbnail(file_path, max_size);
+}
+
+QImage DocumentThumbnailer::render_isolated(const QString& file_path, const QString& mime_type, const QSize& max_size,
+                                            int timeout_ms, const std::function<bool()>& cancelled) {
+    QProcess helper;
+    helper.start(QCoreApplication::applicationFilePath(),
+                 {kRenderHelperFlag, file_path, mime_type,
+                  QString::number(max_size.width()), QString::number(max_size.height())});
+    if (!helper.waitForStarted()) {
+        LOG_WARN("Preview", "Could not start the document render helper");
+        return QImage();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!helper.waitForFinished(kHelperPollMs)) {
+        if (helper.state() == QProcess::NotRunning) break;
+        bool timed_out = timer.elapsed() >= timeout_ms;
+        if (timed_out || (cancelled && cancelled())) {
+            if (timed_out) LOG_WARN("Preview", QString("Document preview timed out: %1").arg(file_path));
+            helper.kill();
+            helper.waitForFinished();
+            return QImage();
+        }
+    }
+    if (helper.exitStatus() != QProcess::NormalExit || helper.exitCode() != 0) return QImage();
+    return QImage::fromData(helper.readAllStandardOutput(), "PNG");
+}
+
+int DocumentThumbnailer::run_render_helper(int argc, char* argv[]) {
+    if (argc < 6) return 2;
+    // No windows are shown; the GUI app only backs fonts and image plugins
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    QSize max_size(QString::fromLocal8Bit(argv[4]).toInt(), QString::fromLocal8Bit(argv[5]).toInt());
+    QImage page = render(QString::fromLocal8Bit(argv[2]), QString::fromLocal8Bit(argv[3]), max_size);
+    if (page.isNull()) return 1;
+
+#ifdef Q_OS_WIN
+    // Text-mode stdout would turn every LF in the PNG into CR LF
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    QFile out;
+    if (!out.open(stdout, QIODevice::WriteOnly)) return 1;
+    return page.save(&out, "PNG") ? 0 : 1;
+}
+
+bool DocumentThumbnailer::is_pdf(const QString& file_path, const QString& mime_type) {
+    return mime_type == "application/pdf" || QFileInfo(file_path).suffix().compare("pdf", Qt::CaseInsensitive) == 0;
+}
+
+QImage DocumentThumbnailer::render_pdf(const QString& file_path, const QSize& max_size) {
+#ifdef FILETINDER_HAS_QT_PDF
+    QPdfDocument doc;
+    if (doc.load(file_path) != QPdfDocument::Error::None || doc.pageCount() < 1) {
+        LOG_DEBUG("Preview", QString("Could not load PDF %1").arg(file_path));
+        return QImage();
+    }
+    QSizeF page_points = doc.pagePointSize(0);
+    if (page_points.isEmpty()) return QImage();
+    QSize target = page_points.toSize().scaled(max_size, Qt::KeepAspectRatio);
+    QImage page = doc.render(0, target);
+    doc.close();
+    return page;
+#else
+    Q_UNUSED(file_path);
+    Q_UNUSED(max_size);
+    return QImage();
+#endif
+}
+
+QImage DocumentThumbnailer::extract_embedded_thumbnail(const QString& file_path, const QSize& max_size) {
+    ZipDirectory zip;
+    if (!zip.open(file_path)) return QImage();
+
+    for (const QString& name : kThumbnailEntries) {
+        const ZipEntry* entry = zip.find(name);
+        if (!entry) continue;
+        QByteArray bytes = zip.read_entry(*entry, kMaxThumbnailBytes);
+        if (bytes.isEmpty()) continue;
+        QImage image = QImage::fromData(bytes);
+        if (image.isNull()) continue;
+        if (image.width() > max_size.width() || image.height() > max_size.height()) {
+            image = image.scaled(max_size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        return image;
+    }
+    return QImage();
+}
@@ -0,0 +1,129 @@
+#include "FileListModel.hpp"
+#include "StandaloneFileTinderDialog.hpp"
+#include "FileSearchIndex.hpp"
+#include <QColor>
+#include <QFont>
+#include <algorithm>
+
+namespace {
+    const QColor kCurrentBackground("#2c3e50");
+
+    QString decision_tag(const QString& decision) {
+        if (decision == "pending") return "[ ]";
+        if (decision == "keep") return "[K]";
+        if (decision == "delete") return "[D]";
+        if (decision == "skip") return "[S]";
+        if (decision == "move") return "[M]";
+        if (decision == "copy") return "[C]";
+        return "[?]";
+    }
+
+    QVariant decision_color(const QString& decision) {
+        if (decision == "keep") return QColor("#2ecc71");
+        if (decision == "delete") return QColor("#e74c3c");
+        if (decision == "skip") return QColor("#95a5a6");
+        if (decision == "move") return QColor("#3498db");
+        if (decision == "copy") return QColor("#9b59b6");
+        return QVariant();
+    }
+}
+
+FileListModel::FileListModel(std::vector<FileToProcess>& files, QObject* parent)
+    : QAbstractListModel(parent)
+    , files_(files) {
+}
+
+int FileListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows_.size());
+}
+
+QVariant FileListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(rows_.size())) return QVariant();
+    int position = rows_[index.row()];
+    int fi = filtered_indices_[position];
+    const FileToProcess& file = files_[fi];
+
+    switch (role) {
+        case Qt::DisplayRole:
+            return QString("%1 %2").arg(decision_tag(file.decision), file.name);
+        case Qt::ForegroundRole:
+            return decision_color(file.decision);
+        case Qt::BackgroundRole:
+            return position == current_index_ ? QVariant(kCurrentBackground) : QVariant();
+        case Qt::FontRole:
+            if (position == current_index_) {
+                QFont font;
+                font.setBold(true);
+                return font;
+            }
+            return QVariant();
+        case Qt::ToolTipRole:
+            return file.path;
+        case FileIndexRole:
+            return fi;
+        case FilteredIndexRole:
+            return position;
+        default:
+            return QVariant();
+    }
+}
+
+Qt::ItemFlags FileListModel::flags(const QModelIndex& index) const {
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsDragEnabled;
+}
+
+void FileListModel::set_order(const std::vector<int>& filtered_indices, int current_index) {
+    beginResetModel();
+    filtered_indices_ = filtered_indices;
+    current_index_ = current_index;
+    rebuild_rows();
+    endResetModel();
+}
+
+void FileListModel::set_name_filter(const QString& text) {
+    if (text == filter_) return;
+    beginResetModel();
+    // Typing more only narrows the match set, so rescan the survivors
+    bool narrowing = !search_index_ && !filter_.isEmpty() && text.contains(filter_, Qt::CaseInsensitive);
+    filter_ = text;
+    if (narrowing) {
+        auto last = std::remove_if(rows_.begin(), rows_.end(), [this](int position) {
+            return !files_[filtered_indices_[position]].name.contains(filter_, Qt::CaseInsensitive);
+        });
+        rows_.erase(last, rows_.end());
+    } else {
+        rebuild_rows();
+    }
+    endResetModel();
+}
+
+void FileListModel::refresh_rows() {
+    if (rows_.empty()) return;
+    emit dataChanged(index(0), index(static_cast<int>(rows_.size()) - 1));
+}
+
+int FileListModel::current_row() const {
+    auto it = std::lower_bound(rows_.begin(), rows_.end(), current_index_);
+    if (it == rows_.end() || *it != current_index_) return -1;
+    return static_cast<int>(it - rows_.begin());
+}
+
+void FileListModel::rebuild_rows() {
+    rows_.clear();
+    const int count = static_cast<int>(filtered_indices_.size());
+    const int file_count = static_cast<int>(files_.size());
+    std::vector<bool> hits;
+    bool use_index = !filter_.isEmpty() && search_index_ && search_index_->size() == file_count;
+    if (use_index) hits = search_index_->match_mask(filter_);
+    for (int position = 0; position < count; ++position) {
+        int fi = filtered_indices_[position];
+        if (fi < 0 || fi >= file_count) continue;
+        if (use_index) {
+            if (!hits[fi]) continue;
+        } else if (!filter_.isEmpty() && !files_[fi].name.contains(filter_, Qt::CaseInsensitive)) {
+            continue;
+        }
+        rows_.push_back(position);
+    }
+}
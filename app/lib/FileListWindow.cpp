@@ -1,4 +1,5 @@
 #include "FileListWindow.hpp"
+#include "FileListModel.hpp"
 #include "StandaloneFileTinderDialog.hpp"
 #include "ui_constants.hpp"
 
@@ -11,21 +12,24 @@
 #include <QFileInfo>
 #include <QApplication>
 #include <QMouseEvent>
+#include <QItemSelectionModel>
 
-static const int kFileIndexRole = Qt::UserRole + 200;
+// Re-filter once typing pauses; each pass walks the whole list
+static const int kFilterDebounceMs = 150;
 
 FileListWindow::FileListWindow(std::vector<FileToProcess>& files,
                                const std::vector<int>& filtered_indices,
                                int current_index,
+                               const FileSearchIndex* search_index,
                                QWidget* parent)
     : QDialog(parent, Qt::Tool | Qt::WindowStaysOnTopHint)
-    , files_(files)
-    , filtered_indices_(filtered_indices)
-    , current_index_(current_index)
+    , model_(new FileListModel(files, this))
 {
     setWindowTitle("File List");
+    model_->set_search_index(search_index);
+    model_->set_order(filtered_indices, current_index);
     build_ui();
-    update_list();
+    update_counts();
 }
 
 void FileListWindow::build_ui() {
@@ -39,29 +43,44 @@ void FileListWindow::build_ui() {
     auto* filter_row = new QHBoxLayout();
     filter_edit_ = new QLineEdit();
     filter_edit_->setPlaceholderText("Filter files...");
+    filter_edit_->setToolTip("Substring match. ^name for prefix, ~abc for fuzzy, * and ? for wildcards");
     filter_edit_->setStyleSheet(
         "padding: 5px 8px; background-color: #2d2d2d; border: 1px solid #555; color: #ecf0f1;");
+    filter_timer_ = new QTimer(this);
+    filter_timer_->setSingleShot(true);
+    filter_timer_->setInterval(kFilterDebounceMs);
+    connect(filter_timer_, &QTimer::timeout, this, [this]() {
+        model_->set_name_filter(filter_edit_->text());
+        update_counts();
+    });
     connect(filter_edit_, &QLineEdit::textChanged, this, &FileListWindow::on_filter_changed);
     filter_row->addWidget(filter_edit_);
     layout->addLayout(filter_row);
 
-    // File list
-    list_widget_ = new QListWidget();
-    list_widget_->setSelectionMode(QAbstractItemView::ExtendedSelection);
-    list_widget_->setDragEnabled(true);
-    list_widget_->setStyleSheet(
-        "QListWidget { background-color: #1e1e1e; border: 1px solid #404040; color: #ecf0f1; }"
-        "QListWidget::item { padding: 3px 6px; border-bottom: 1px solid #333; }"
-        "QListWidget::item:selected { background-color: #0078d4; }"
-        "QListWidget::item:hover { background-color: #2a2a2a; }");
-    connect(list_widget_, &QListWidget::itemClicked, this, &FileListWindow::on_item_clicked);
-    connect(list_widget_, &QListWidget::itemDoubleClicked, this, &FileListWindow::on_item_double_clicked);
+    // File list: rows come from the model on demand, all the same height,
+    // so only the visible ones are ever laid out
+    list_view_ = new QListView();
+    list_view_->setModel(model_);
+    list_view_->setUniformItemSizes(true);
+    list_view_->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    list_view_->setDragEnabled(true);
+    list_view_->setStyleSheet(
+        "QListView { background-color: #1e1e1e; border: 1px solid #404040; color: #ecf0f1; }"
+        "QListView::item { padding: 3px 6px; border-bottom: 1px solid #333; }"
+        "QListView::item:selected { background-color: #0078d4; }"
+        "QListView::item:hover { background-color: #2a2a2a; }");
+    connect(list_view_, &QListView::clicked, this, &FileListWindow::on_item_clicked);
+    connect(list_view_, &QListView::doubleClicked, this, &FileListWindow::on_item_double_clicked);
+    connect(list_view_->selectionModel(), &QItemSelectionModel::selectionChanged, this, [this]() {
+        int sel = static_cast<int>(list_view_->selectionModel()->selectedRows().size());
+        selection_label_->setText(QString("%1 selected").arg(sel));
+    });
 
     // Context menu for assigning selected files
-    list_widget_->setContextMenuPolicy(Qt::CustomContextMenu);
-    connect(list_widget_, &QListWidget::customContextMenuRequested, this, [this](const QPoint& pos) {
-        auto selected = list_widget_->selectedItems();
-        if (selected.isEmpty() || destination_folders_.isEmpty()) return;
+    list_view_->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(list_view_, &QListView::customContextMenuRequested, this, [this](const QPoint& pos) {
+        QList<int> indices = selected_file_indices();
+        if (indices.isEmpty() || destination_folders_.isEmpty()) return;
 
         QMenu menu(this);
         auto* header = menu.addAction("Move selected to:");
@@ -76,18 +95,13 @@ void FileListWindow::build_ui() {
             action->setToolTip(folder);
         }
 
-        auto* chosen = menu.exec(list_widget_->viewport()->mapToGlobal(pos));
+        auto* chosen = menu.exec(list_view_->viewport()->mapToGlobal(pos));
         if (chosen && chosen->data().isValid()) {
-            QList<int> indices;
-            for (auto* item : selected) {
-                int fi = item->data(kFileIndexRole).toInt();
-                indices.append(fi);
-            }
             emit files_assigned(indices, chosen->data().toString());
         }
     });
 
-    layout->addWidget(list_widget_, 1);
+    layout->addWidget(list_view_, 1);
 
     // Status bar
     auto* status_row = new QHBoxLayout();
@@ -108,88 +122,42 @@ void FileListWindow::build_ui() {
 }
 
 void FileListWindow::refresh(const std::vector<int>& filtered_indices, int current_index) {
-    filtered_indices_ = filtered_indices;
-    current_index_ = current_index;
-    update_list();
+    model_->set_order(filtered_indices, current_index);
+    update_counts();
+    int row = model_->current_row();
+    if (row >= 0) list_view_->scrollTo(model_->index(row), QAbstractItemView::EnsureVisible);
 }
 
 void FileListWindow::set_destination_folders(const QStringList& folders) {
     destination_folders_ = folders;
 }
 
-void FileListWindow::update_list() {
-    list_widget_->clear();
-    QString filter_text = filter_edit_->text().toLower();
-
-    int shown = 0;
-    for (int i = 0; i < static_cast<int>(filtered_indices_.size()); ++i) {
-        int fi = filtered_indices_[i];
-        if (fi < 0 || fi >= static_cast<int>(files_.size())) continue;
-        const auto& file = files_[fi];
-
-        // Apply text filter
-        if (!filter_text.isEmpty() && !file.name.toLower().contains(filter_text)) continue;
-
-        // Build display text
-        QString status;
-        if (file.decision == "pending") status = "[ ]";
-        else if (file.decision == "keep") status = "[K]";
-        else if (file.decision == "delete") status = "[D]";
-        else if (file.decision == "skip") status = "[S]";
-        else if (file.decision == "move") status = "[M]";
-        else if (file.decision == "copy") status = "[C]";
-        else status = "[?]";
-
-        QString display = QString("%1 %2").arg(status, file.name);
-
-        auto* item = new QListWidgetItem(display);
-        item->setData(kFileIndexRole, fi);
-        item->setData(Qt::UserRole + 201, i);  // filtered index
-
-        // Color by decision
-        if (file.decision == "keep") item->setForeground(QColor("#2ecc71"));
-        else if (file.decision == "delete") item->setForeground(QColor("#e74c3c"));
-        else if (file.decision == "skip") item->setForeground(QColor("#95a5a6"));
-        else if (file.decision == "move") item->setForeground(QColor("#3498db"));
-        else if (file.decision == "copy") item->setForeground(QColor("#9b59b6"));
-
-        // Highlight current file
-        if (i == current_index_) {
-            item->setBackground(QColor("#2c3e50"));
-            auto font = item->font();
-            font.setBold(true);
-            item->setFont(font);
-        }
-
-        item->setToolTip(file.path);
-        list_widget_->addItem(item);
-        ++shown;
-    }
-
-    count_label_->setText(QString("%1 / %2 files").arg(shown).arg(filtered_indices_.size()));
+void FileListWindow::update_counts() {
+    count_label_->setText(QString("%1 / %2 files").arg(model_->rowCount()).arg(model_->total_count()));
     selection_label_->setText("0 selected");
+}
 
-    connect(list_widget_, &QListWidget::itemSelectionChanged, this, [this]() {
-        int sel = list_widget_->selectedItems().size();
-        selection_label_->setText(QString("%1 selected").arg(sel));
-    });
+QList<int> FileListWindow::selected_file_indices() const {
+    QList<int> indices;
+    for (const QModelIndex& index : list_view_->selectionModel()->selectedRows()) {
+        indices.append(index.data(FileListModel::FileIndexRole).toInt());
+    }
+    return indices;
 }
 
 void FileListWindow::on_filter_changed(const QString&) {
-    update_list();
+    filter_timer_->start();
 }
 
-void FileListWindow::on_item_clicked(QListWidgetItem* item) {
-    if (!item) return;
+void FileListWindow::on_item_clicked(const QModelIndex& index) {
+    if (!index.isValid()) return;
     // Only navigate on single-click without modifier keys
     if (QApplication::keyboardModifiers() & (Qt::ShiftModifier | Qt::ControlModifier))
         return;
-    int filtered_idx = item->data(Qt::UserRole + 201).toInt();
-    emit file_selected(filtered_idx);
+    emit file_selected(index.data(FileListModel::FilteredIndexRole).toInt());
 }
 
-void FileListWindow::on_item_double_clicked(QListWidgetItem* item) {
-    if (!item) return;
-    int filtered_idx = item->data(Qt::UserRole + 201).toInt();
-    emit file_selected(filtered_idx);
+void FileListWindow::on_item_double_clicked(const QModelIndex& index) {
+    if (!index.isValid()) return;
+    emit file_selected(index.data(FileListModel::FilteredIndexRole).toInt());
 }
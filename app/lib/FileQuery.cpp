@@ -0,0 +1,503 @@
+#include "FileQuery.hpp"
+#include "FileSearchIndex.hpp"
+#include "StandaloneFileTinderDialog.hpp"
+#include <QDate>
+#include <QDateTime>
+#include <QRegularExpression>
+#include <functional>
+
+namespace {
+    // One bit per category so "type:image,video" is a single AND per file
+    enum CategoryBit : quint8 {
+        kImageBit = 0x01,
+        kVideoBit = 0x02,
+        kAudioBit = 0x04,
+        kDocumentBit = 0x08,
+        kArchiveBit = 0x10,
+        kFolderBit = 0x20,
+        kOtherBit = 0x40
+    };
+
+    // Same buckets as the filter combo
+    quint8 category_for(const FileToProcess& file) {
+        if (file.is_directory) return kFolderBit;
+        QString mime = file.mime_type.toLower();
+        if (mime.startsWith("image/")) return kImageBit;
+        if (mime.startsWith("video/")) return kVideoBit;
+        if (mime.startsWith("audio/")) return kAudioBit;
+        if (mime.startsWith("text/") || mime.contains("pdf") || mime.contains("document") ||
+            mime.contains("spreadsheet") || mime.contains("presentation")) return kDocumentBit;
+        if (mime.contains("zip") || mime.contains("tar") || mime.contains("archive") ||
+            mime.contains("compressed")) return kArchiveBit;
+        return kOtherBit;
+    }
+
+    quint8 category_named(const QString& name) {
+        if (name == "image" || name == "images" || name == "photo") return kImageBit;
+        if (name == "video" || name == "videos") return kVideoBit;
+        if (name == "audio" || name == "music") return kAudioBit;
+        if (name == "document" || name == "documents" || name == "doc") return kDocumentBit;
+        if (name == "archive" || name == "archives") return kArchiveBit;
+        if (name == "folder" || name == "folders" || name == "dir") return kFolderBit;
+        if (name == "other") return kOtherBit;
+        return 0;
+    }
+
+    enum class Op { Less, LessEqual, Greater, GreaterEqual, Equal };
+
+    // Tight loop over a flat column; the compiler can vectorize this
+    template <typename Compare>
+    void compare_column(const qint64* src, qint64 value, std::vector<quint8>& out, Compare compare) {
+        quint8* dst = out.data();
+        const size_t n = out.size();
+        for (size_t i = 0; i < n; ++i) dst[i] = compare(src[i], value) ? 1 : 0;
+    }
+
+    void compare_column(const qint64* src, Op op, qint64 value, std::vector<quint8>& out) {
+        switch (op) {
+            case Op::Less: compare_column(src, value, out, std::less<qint64>()); break;
+            case Op::LessEqual: compare_column(src, value, out, std::less_equal<qint64>()); break;
+            case Op::Greater: compare_column(src, value, out, std::greater<qint64>()); break;
+            case Op::GreaterEqual: compare_column(src, value, out, std::greater_equal<qint64>()); break;
+            case Op::Equal: compare_column(src, value, out, std::equal_to<qint64>()); break;
+        }
+    }
+
+    void test_bits(const quint8* src, quint8 bits, std::vector<quint8>& out) {
+        quint8* dst = out.data();
+        const size_t n = out.size();
+        for (size_t i = 0; i < n; ++i) dst[i] = (src[i] & bits) ? 1 : 0;
+    }
+
+    // "2GB", "500k", "1.5 MiB", "1024"
+    bool parse_size(const QString& text, qint64& bytes) {
+        static const QRegularExpression re("^(\\d+(?:\\.\\d+)?)\\s*([kmgt]?)(?:i?b)?$",
+                                           QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatch m = re.match(text);
+        if (!m.hasMatch()) return false;
+        QString unit = m.captured(2).toLower();
+        int shift = unit.isEmpty() ? 0 : unit == "k" ? 10 : unit == "m" ? 20 : unit == "g" ? 30 : 40;
+        bytes = static_cast<qint64>(m.captured(1).toDouble() * static_cast<double>(qint64(1) << shift));
+        return true;
+    }
+
+    // "36h", "10d", "2w", "6m", "2y"
+    bool parse_duration(const QString& text, qint64& secs) {
+        static const QRegularExpression re("^(\\d+(?:\\.\\d+)?)\\s*(h|d|w|mo|m|y)$",
+                                           QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatch m = re.match(text);
+        if (!m.hasMatch()) return false;
+        QString unit = m.captured(2).toLower();
+        qint64 unit_secs = unit == "h" ? 3600 : unit == "d" ? 86400 : unit == "w" ? 7 * 86400
+                         : unit == "y" ? 365 * 86400 : 30 * 86400;
+        secs = static_cast<qint64>(m.captured(1).toDouble() * static_cast<double>(unit_secs));
+        return true;
+    }
+
+    QRegularExpression wildcard_regex(const QString& glob) {
+        return QRegularExpression(QRegularExpression::wildcardToRegularExpression(glob),
+                                  QRegularExpression::CaseInsensitiveOption);
+    }
+
+    // Evaluation covers files [begin, end); masks are indexed from begin
+    struct EvalContext {
+        const std::vector<FileToProcess>& files;
+        const FileQuery::Columns& columns;
+        const FileSearchIndex* index;
+        int begin;
+        int end;
+    };
+}
+
+struct FileQuery::Node {
+    enum class Kind { And, Or, Not, Size, Mtime, Category, Flag, Extension, NameText, NameGlob, NameRegex, Decision };
+
+    Kind kind = Kind::And;
+    Op op = Op::Equal;
+    qint64 number = 0;          // Size, time or bit mask
+    QString text;               // Name substring or glob
+    QStringList values;         // Extensions or decisions
+    QRegularExpression regex;   // Name glob or regex
+    std::vector<Node> children;
+
+    void eval(const EvalContext& ctx, std::vector<quint8>& out) const;
+};
+
+void FileQuery::Node::eval(const EvalContext& ctx, std::vector<quint8>& out) const {
+    const size_t n = static_cast<size_t>(ctx.end - ctx.begin);
+    const FileToProcess* files = ctx.files.data() + ctx.begin;
+    out.assign(n, 0);
+
+    switch (kind) {
+        case Kind::And:
+        case Kind::Or: {
+            children.front().eval(ctx, out);
+            std::vector<quint8> other;
+            for (size_t c = 1; c < children.size(); ++c) {
+                children[c].eval(ctx, other);
+                if (kind == Kind::And) {
+                    for (size_t i = 0; i < n; ++i) out[i] &= other[i];
+                } else {
+                    for (size_t i = 0; i < n; ++i) out[i] |= other[i];
+                }
+            }
+            break;
+        }
+        case Kind::Not:
+            children.front().eval(ctx, out);
+            for (size_t i = 0; i < n; ++i) out[i] ^= 1;
+            break;
+        case Kind::Size:
+            compare_column(ctx.columns.size.data() + ctx.begin, op, number, out);
+            break;
+        case Kind::Mtime:
+            compare_column(ctx.columns.mtime.data() + ctx.begin, op, number, out);
+            break;
+        case Kind::Category:
+            test_bits(ctx.columns.category.data() + ctx.begin, static_cast<quint8>(number), out);
+            break;
+        case Kind::Flag:
+            test_bits(ctx.columns.flags.data() + ctx.begin, static_cast<quint8>(number), out);
+            break;
+        case Kind::Extension:
+            for (size_t i = 0; i < n; ++i) out[i] = values.contains(files[i].extension) ? 1 : 0;
+            break;
+        case Kind::NameText:
+        case Kind::NameGlob:
+            if (ctx.index && ctx.index->size() == static_cast<int>(ctx.files.size())) {
+                auto mode = kind == Kind::NameGlob ? FileSearchIndex::MatchMode::Glob
+                                                   : FileSearchIndex::MatchMode::Substring;
+                for (int fi : ctx.index->find(text, mode)) {
+                    if (fi >= ctx.begin && fi < ctx.end) out[fi - ctx.begin] = 1;
+                }
+            } else if (kind == Kind::NameGlob) {
+                for (size_t i = 0; i < n; ++i) out[i] = regex.match(files[i].name).hasMatch() ? 1 : 0;
+            } else {
+                for (size_t i = 0; i < n; ++i) out[i] = files[i].name.contains(text, Qt::CaseInsensitive) ? 1 : 0;
+            }
+            break;
+        case Kind::NameRegex:
+            for (size_t i = 0; i < n; ++i) out[i] = regex.match(files[i].name).hasMatch() ? 1 : 0;
+            break;
+        case Kind::Decision:
+            for (size_t i = 0; i < n; ++i) out[i] = values.contains(files[i].decision) ? 1 : 0;
+            break;
+    }
+}
+
+// Recursive descent over whitespace-separated tokens:
+//   or_expr  := and_expr ("or" and_expr)*
+//   and_expr := unary ("and"? unary)*
+//   unary    := ("not" | "-") unary | "(" or_expr ")" | term
+class FileQuery::Parser {
+public:
+    explicit Parser(const QString& text) { tokenize(text); }
+
+    std::shared_ptr<const Node> parse(QString& error) {
+        Node root;
+        if (error_.isEmpty()) root = parse_or();
+        if (error_.isEmpty() && pos_ < tokens_.size()) {
+            error_ = QString("Unexpected '%1'").arg(tokens_[pos_].text);
+        }
+        error = error_;
+        if (!error_.isEmpty()) return nullptr;
+        return std::make_shared<const Node>(std::move(root));
+    }
+
+private:
+    struct Token {
+        QString text;
+        bool paren = false;
+    };
+
+    void tokenize(const QString& text) {
+        QString current;
+        bool in_quote = false;
+        bool in_regex = false;
+        auto flush = [&]() {
+            if (!current.isEmpty()) tokens_.push_back({current, false});
+            current.clear();
+        };
+        for (qsizetype i = 0; i < text.size(); ++i) {
+            QChar c = text[i];
+            if (in_regex) {
+                current += c;
+                if (c == u'\\' && i + 1 < text.size()) current += text[++i];
+                else if (c == u'/') in_regex = false;
+                continue;
+            }
+            if (in_quote) {
+                if (c == u'"') in_quote = false;
+                else current += c;
+                continue;
+            }
+            if (c == u'"') {
+                in_quote = true;
+            } else if (c.isSpace()) {
+                flush();
+            } else if ((c == u'(' && (current.isEmpty() || current == "-")) || c == u')') {
+                flush();
+                tokens_.push_back({QString(c), true});
+            } else {
+                current += c;
+                // "name:/" opens a regex literal; spaces and parens are part of it
+                if (c == u'/' && current.endsWith(":/")) in_regex = true;
+            }
+        }
+        if (in_quote) error_ = "Unterminated quote";
+        else if (in_regex) error_ = "Unterminated /regex/";
+        flush();
+    }
+
+    bool at_keyword(const char* word) const {
+        return pos_ < tokens_.size() && !tokens_[pos_].paren
+            && tokens_[pos_].text.compare(QLatin1String(word), Qt::CaseInsensitive) == 0;
+    }
+
+    bool at_paren(QChar c) const {
+        return pos_ < tokens_.size() && tokens_[pos_].paren && tokens_[pos_].text[0] == c;
+    }
+
+    static Node combine(Node::Kind kind, std::vector<Node> children) {
+        if (children.size() == 1) return std::move(children.front());
+        Node node;
+        node.kind = kind;
+        node.children = std::move(children);
+        return node;
+    }
+
+    static Node negate(Node child) {
+        Node node;
+        node.kind = Node::Kind::Not;
+        node.children.push_back(std::move(child));
+        return node;
+    }
+
+    Node parse_or() {
+        std::vector<Node> children;
+        children.push_back(parse_and());
+        while (error_.isEmpty() && at_keyword("or")) {
+            ++pos_;
+            children.push_back(parse_and());
+        }
+        return combine(Node::Kind::Or, std::move(children));
+    }
+
+    Node parse_and() {
+        std::vector<Node> children;
+        while (error_.isEmpty() && pos_ < tokens_.size() && !at_paren(u')') && !at_keyword("or")) {
+            if (at_keyword("and")) {
+                ++pos_;
+                continue;
+            }
+            children.push_back(parse_unary());
+        }
+        if (children.empty()) {
+            if (error_.isEmpty()) error_ = "Expected a term";
+            return Node();
+        }
+        return combine(Node::Kind::And, std::move(children));
+    }
+
+    Node parse_unary() {
+        if (pos_ >= tokens_.size()) {
+            error_ = "Expected a term";
+            return Node();
+        }
+        if (at_paren(u'(')) {
+            ++pos_;
+            Node inner = parse_or();
+            if (error_.isEmpty() && !at_paren(u')')) error_ = "Missing ')'";
+            ++pos_;
+            return inner;
+        }
+        if (at_paren(u')')) {
+            error_ = "Unexpected ')'";
+            return Node();
+        }
+        QString token = tokens_[pos_++].text;
+        if (token.compare("not", Qt::CaseInsensitive) == 0 || token == "-") return negate(parse_unary());
+        if (token.startsWith(u'-')) return negate(parse_term(token.mid(1)));
+        return parse_term(token);
+    }
+
+    static Node name_node(const QString& value) {
+        Node node;
+        node.text = value;
+        if (value.contains(u'*') || value.contains(u'?')) {
+            node.kind = Node::Kind::NameGlob;
+            node.regex = wildcard_regex(value);
+        } else {
+            node.kind = Node::Kind::NameText;
+        }
+        return node;
+    }
+
+    Node parse_term(const QString& term) {
+        static const QRegularExpression field_re("^([a-z]+)(>=|<=|!=|:|=|>|<)(.*)$",
+                                                 QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatch m = field_re.match(term);
+        if (!m.hasMatch()) return name_node(term);
+
+        QString field = m.captured(1).toLower();
+        QString op_text = m.captured(2);
+        QString value = m.captured(3);
+        if (value.isEmpty()) {
+            error_ = QString("Missing value for '%1'").arg(field);
+            return Node();
+        }
+        bool negated = op_text == "!=";
+        Op op = op_text == "<" ? Op::Less : op_text == "<=" ? Op::LessEqual
+              : op_text == ">" ? Op::Greater : op_text == ">=" ? Op::GreaterEqual : Op::Equal;
+        bool ordered = op_text == "<" || op_text == "<=" || op_text == ">" || op_text == ">=";
+
+        Node node;
+        if (field == "size") {
+            node.kind = Node::Kind::Size;
+            node.op = op;
+            if (!parse_size(value, node.number)) error_ = QString("Bad size '%1'").arg(value);
+        } else if (field == "age") {
+            // Older than N means modified before now - N
+            qint64 secs = 0;
+            if (!ordered) error_ = "Use < or > with age";
+            else if (!parse_duration(value, secs)) error_ = QString("Bad age '%1'").arg(value);
+            node.kind = Node::Kind::Mtime;
+            node.number = QDateTime::currentSecsSinceEpoch() - secs;
+            node.op = op == Op::Less ? Op::Greater : op == Op::LessEqual ? Op::GreaterEqual
+                    : op == Op::Greater ? Op::Less : Op::LessEqual;
+        } else if (field == "modified" || field == "mtime") {
+            QDate date = QDate::fromString(value, Qt::ISODate);
+            if (!date.isValid()) {
+                error_ = QString("Bad date '%1' (use yyyy-MM-dd)").arg(value);
+                return Node();
+            }
+            // A date covers the whole day
+            qint64 day_start = date.startOfDay().toSecsSinceEpoch();
+            qint64 next_day = date.addDays(1).startOfDay().toSecsSinceEpoch();
+            node.kind = Node::Kind::Mtime;
+            switch (op) {
+                case Op::Less: node.op = Op::Less; node.number = day_start; break;
+                case Op::LessEqual: node.op = Op::Less; node.number = next_day; break;
+                case Op::Greater: node.op = Op::GreaterEqual; node.number = next_day; break;
+                case Op::GreaterEqual: node.op = Op::GreaterEqual; node.number = day_start; break;
+                case Op::Equal: {
+                    Node after = node;
+                    after.op = Op::GreaterEqual;
+                    after.number = day_start;
+                    Node before = node;
+                    before.op = Op::Less;
+                    before.number = next_day;
+                    node = combine(Node::Kind::And, {after, before});
+                    break;
+                }
+            }
+        } else if (ordered) {
+            error_ = QString("'%1' only supports ':' and '!='").arg(field);
+        } else if (field == "type" || field == "kind") {
+            node.kind = Node::Kind::Category;
+            for (const QString& name : value.toLower().split(',', Qt::SkipEmptyParts)) {
+                quint8 bit = category_named(name.trimmed());
+                if (!bit) error_ = QString("Unknown type '%1'").arg(name);
+                node.number |= bit;
+            }
+        } else if (field == "ext") {
+            node.kind = Node::Kind::Extension;
+            for (QString ext : value.toLower().split(',', Qt::SkipEmptyParts)) {
+                ext = ext.trimmed();
+                if (ext.startsWith(u'.')) ext = ext.mid(1);
+                node.values.append(ext);
+            }
+        } else if (field == "name") {
+            if (value.size() >= 2 && value.startsWith(u'/') && value.endsWith(u'/')) {
+                node.kind = Node::Kind::NameRegex;
+                node.regex = QRegularExpression(value.mid(1, value.size() - 2), QRegularExpression::CaseInsensitiveOption);
+                if (!node.regex.isValid()) error_ = QString("Bad regex: %1").arg(node.regex.errorString());
+            } else {
+                node = name_node(value);
+            }
+        } else if (field == "decision") {
+            static const QStringList kDecisions = {"pending", "keep", "delete", "skip", "move", "copy"};
+            node.kind = Node::Kind::Decision;
+            for (const QString& decision : value.toLower().split(',', Qt::SkipEmptyParts)) {
+                if (!kDecisions.contains(decision.trimmed())) error_ = QString("Unknown decision '%1'").arg(decision);
+                node.values.append(decision.trimmed());
+            }
+        } else if (field == "is" || field == "has") {
+            QString what = value.toLower();
+            node.kind = Node::Kind::Flag;
+            if (what == "duplicate" || what == "dup") {
+                node.number = kDuplicateFlag;
+            } else if (what == "folder" || what == "dir") {
+                node.number = kFolderFlag;
+            } else if (what == "file") {
+                node.number = kFolderFlag;
+                negated = !negated;
+            } else {
+                error_ = QString("Unknown flag '%1'").arg(value);
+            }
+        } else {
+            error_ = QString("Unknown field '%1'").arg(field);
+        }
+        return negated ? negate(std::move(node)) : node;
+    }
+
+    std::vector<Token> tokens_;
+    size_t pos_ = 0;
+    QString error_;
+};
+
+// === Columns ===
+
+void FileQuery::Columns::clear() {
+    size.clear();
+    mtime.clear();
+    category.clear();
+    flags.clear();
+}
+
+void FileQuery::Columns::build(const std::vector<FileToProcess>& files) {
+    clear();
+    size.reserve(files.size());
+    mtime.reserve(files.size());
+    category.reserve(files.size());
+    flags.reserve(files.size());
+    for (const auto& file : files) {
+        size.push_back(file.size);
+        mtime.push_back(file.modified_datetime.isValid() ? file.modified_datetime.toSecsSinceEpoch() : 0);
+        category.push_back(category_for(file));
+        flags.push_back((file.is_directory ? kFolderFlag : 0) | (file.has_duplicate ? kDuplicateFlag : 0));
+    }
+}
+
+// === FileQuery ===
+
+FileQuery FileQuery::compile(const QString& text) {
+    FileQuery query;
+    query.text_ = text.trimmed();
+    if (query.text_.isEmpty()) return query;
+    Parser parser(query.text_);
+    query.root_ = parser.parse(query.error_);
+    return query;
+}
+
+std::vector<quint8> FileQuery::evaluate(const std::vector<FileToProcess>& files, const Columns& columns,
+                                        const FileSearchIndex* index) const {
+    return evaluate(files, columns, index, 0, static_cast<int>(files.size()));
+}
+
+std::vector<quint8> FileQuery::evaluate(const std::vector<FileToProcess>& files, const Columns& columns,
+                                        const FileSearchIndex* index, int begin, int end) const {
+    if (!root_) return std::vector<quint8>(end - begin, 1);
+
+    // Columns from an older scan would be misaligned; build fresh ones
+    Columns local;
+    const Columns* cols = &columns;
+    if (columns.count() != static_cast<int>(files.size())) {
+        local.build(files);
+        cols = &local;
+    }
+    EvalContext ctx{files, *cols, index, begin, end};
+    std::vector<quint8> result;
+    root_->eval(ctx, result);
+    return result;
+}
@@ -0,0 +1,200 @@
+#include "FileSearchIndex.hpp"
+#include "StandaloneFileTinderDialog.hpp"
+#include "AppLogger.hpp"
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <algorithm>
+
+namespace {
+    // Ends every name in the buffer so a match can never span two names
+    const QChar kNameSeparator(u'\0');
+
+    bool is_subsequence(QStringView needle, QStringView name) {
+        qsizetype n = 0;
+        for (qsizetype i = 0; i < name.size() && n < needle.size(); ++i) {
+            if (name[i] == needle[n]) ++n;
+        }
+        return n == needle.size();
+    }
+
+    // Longest run of plain characters in a glob, used to narrow candidates.
+    // A character class matches one of its members, so none of it is literal.
+    QStringView longest_literal(QStringView glob) {
+        QStringView best;
+        qsizetype start = 0;
+        for (qsizetype i = 0; i <= glob.size(); ++i) {
+            if (i == glob.size() || glob[i] == u'*' || glob[i] == u'?' || glob[i] == u'[') {
+                if (i - start > best.size()) best = glob.mid(start, i - start);
+                if (i < glob.size() && glob[i] == u'[') {
+                    // A leading ']' (after an optional '!') is a member, not the end
+                    qsizetype j = i + 1;
+                    if (j < glob.size() && (glob[j] == u'!' || glob[j] == u'^')) ++j;
+                    if (j < glob.size() && glob[j] == u']') ++j;
+                    while (j < glob.size() && glob[j] != u']') ++j;
+                    // Unclosed: nothing after it is known to be literal
+                    if (j >= glob.size()) return best;
+                    i = j;
+                }
+                start = i + 1;
+            }
+        }
+        return best;
+    }
+}
+
+void FileSearchIndex::clear() {
+    text_.clear();
+    offsets_.clear();
+    trigrams_.clear();
+}
+
+void FileSearchIndex::build(const std::vector<FileToProcess>& files) {
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+    offsets_.reserve(files.size() + 1);
+
+    std::vector<quint64> keys;
+    for (int fi = 0; fi < static_cast<int>(files.size()); ++fi) {
+        offsets_.push_back(static_cast<int>(text_.size()));
+        QString name = normalize(files[fi].name);
+        text_.append(name);
+        text_.append(kNameSeparator);
+
+        // Each trigram once per name, so posting lists stay sorted and unique
+        keys.clear();
+        for (qsizetype i = 0; i + 3 <= name.size(); ++i) keys.push_back(trigram_key(name.constData() + i));
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        for (quint64 key : keys) trigrams_[key].push_back(fi);
+    }
+    offsets_.push_back(static_cast<int>(text_.size()));
+
+    LOG_DEBUG("Search", QString("Indexed %1 names (%2 trigrams) in %3 ms")
+        .arg(files.size()).arg(trigrams_.size()).arg(timer.elapsed()));
+}
+
+QString FileSearchIndex::normalize(const QString& text) {
+    // Decompose, drop the combining marks, then fold case: "Café" -> "cafe"
+    QString decomposed = text.normalized(QString::NormalizationForm_KD);
+    QString result;
+    result.reserve(decomposed.size());
+    for (QChar c : decomposed) {
+        if (c.category() == QChar::Mark_NonSpacing) continue;
+        result.append(c);
+    }
+    return result.toCaseFolded();
+}
+
+FileSearchIndex::MatchMode FileSearchIndex::mode_for(const QString& query, QString* term) {
+    MatchMode mode = MatchMode::Substring;
+    QString rest = query;
+    if (query.startsWith(u'^')) {
+        mode = MatchMode::Prefix;
+        rest = query.mid(1);
+    } else if (query.startsWith(u'~')) {
+        mode = MatchMode::Fuzzy;
+        rest = query.mid(1);
+    } else if (query.contains(u'*') || query.contains(u'?')) {
+        mode = MatchMode::Glob;
+    }
+    if (term) *term = rest;
+    return mode;
+}
+
+QStringView FileSearchIndex::name_at(int file_index) const {
+    int start = offsets_[file_index];
+    return QStringView(text_).mid(start, offsets_[file_index + 1] - start - 1);
+}
+
+bool FileSearchIndex::candidates(QStringView literal, std::vector<int>& out) const {
+    out.clear();
+    if (literal.size() < 3) return false;
+
+    std::vector<const std::vector<int>*> lists;
+    for (qsizetype i = 0; i + 3 <= literal.size(); ++i) {
+        auto it = trigrams_.constFind(trigram_key(literal.data() + i));
+        if (it == trigrams_.constEnd()) return true;   // A trigram nobody has: no matches
+        lists.push_back(&it.value());
+    }
+    // Intersect smallest first so the working set only shrinks
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+    out = *lists.front();
+    std::vector<int> next;
+    for (size_t i = 1; i < lists.size() && !out.empty(); ++i) {
+        next.clear();
+        std::set_intersection(out.begin(), out.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(next));
+        out.swap(next);
+    }
+    return true;
+}
+
+std::vector<int> FileSearchIndex::scan(QStringView needle) const {
+    std::vector<int> result;
+    QStringView haystack(text_);
+    qsizetype from = 0;
+    qsizetype pos;
+    while ((pos = haystack.indexOf(needle, from)) >= 0) {
+        int fi = static_cast<int>(std::upper_bound(offsets_.begin(), offsets_.end(), pos) - offsets_.begin()) - 1;
+        result.push_back(fi);
+        from = offsets_[fi + 1];   // One hit per name is enough
+    }
+    return result;
+}
+
+std::vector<int> FileSearchIndex::find(const QString& query) const {
+    QString term;
+    MatchMode mode = mode_for(query, &term);
+    return find(term, mode);
+}
+
+std::vector<int> FileSearchIndex::find(const QString& term, MatchMode mode) const {
+    QString needle = normalize(term);
+    if (needle.isEmpty() || size() == 0) return {};
+
+    // Check `accept` against the narrowed candidates, or every name
+    std::vector<int> result;
+    auto filter = [&](QStringView literal, auto accept) {
+        std::vector<int> narrowed;
+        if (candidates(literal, narrowed)) {
+            for (int fi : narrowed) {
+                if (accept(name_at(fi))) result.push_back(fi);
+            }
+        } else {
+            for (int fi = 0; fi < size(); ++fi) {
+                if (accept(name_at(fi))) result.push_back(fi);
+            }
+        }
+    };
+
+    switch (mode) {
+        case MatchMode::Substring:
+            if (needle.size() < 3) return scan(needle);
+            filter(needle, [&](QStringView name) { return name.contains(needle); });
+            break;
+        case MatchMode::Prefix:
+            filter(needle, [&](QStringView name) { return name.startsWith(needle); });
+            break;
+        case MatchMode::Glob: {
+            QRegularExpression pattern(QRegularExpression::wildcardToRegularExpression(needle));
+            if (!pattern.isValid()) return {};
+            filter(longest_literal(needle), [&](QStringView name) {
+                return pattern.match(name.toString()).hasMatch();
+            });
+            break;
+        }
+        case MatchMode::Fuzzy:
+            for (int fi = 0; fi < size(); ++fi) {
+                if (is_subsequence(needle, name_at(fi))) result.push_back(fi);
+            }
+            break;
+    }
+    return result;
+}
+
+std::vector<bool> FileSearchIndex::match_mask(const QString& query) const {
+    std::vector<bool> mask(size(), false);
+    for (int fi : find(query)) mask[fi] = true;
+    return mask;
+}
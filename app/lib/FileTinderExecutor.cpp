@@ -2,6 +2,10 @@
 #include <QFile>
 #include <QDir>
 #include <QFileInfo>
+#include <QStorageInfo>
+#include <QLocale>
+#include <QHash>
+#include <QSet>
 #include <QDebug>
 
 #ifdef Q_OS_WIN
@@ -14,6 +18,40 @@
 #include <QStandardPaths>
 #endif
 
+static const int kMaxNameAttempts = 10000;
+
+// Rough per-operation costs for the dry-run duration estimate
+static const qint64 kRenameCostUs = 500;
+static const qint64 kTrashCostUs = 20000;   // Trash goes through a helper process on some platforms
+static const qint64 kCopyBytesPerSec = 80LL * 1024 * 1024;
+
+// "name_3.ext", the scheme used for every collision
+static QString numbered_name(const QString& base, const QString& ext, int counter) {
+    if (ext.isEmpty()) return QString("%1_%2").arg(base, QString::number(counter));
+    return QString("%1_%2.%3").arg(base, QString::number(counter), ext);
+}
+
+// Key for comparing names within one folder, case-insensitive where the
+// file system usually is
+static QString name_key(const QString& name) {
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    return name.toCaseFolded();
+#else
+    return name;
+#endif
+}
+
+// Closest path at or above `path` that exists, for permission and device checks
+static QString existing_ancestor(const QString& path) {
+    QString current = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    while (!QFileInfo::exists(current)) {
+        QString parent = QFileInfo(current).absolutePath();
+        if (parent == current) break;
+        current = parent;
+    }
+    return current;
+}
+
 FileTinderExecutor::FileTinderExecutor()
     : use_trash_(true)
     , overwrite_existing_(false) {
@@ -27,6 +65,7 @@ ExecutionResult FileTinderExecutor::execute(const ExecutionPlan& plan, ProgressC
     int total_operations = static_cast<int>(
         plan.folders_to_create.size() + 
         plan.files_to_move.size() + 
+        plan.files_to_copy.size() + 
         plan.files_to_delete.size()
     );
     
@@ -49,7 +88,13 @@ ExecutionResult FileTinderExecutor::execute(const ExecutionPlan& plan, ProgressC
         result.success = false;
     }
     
-    // Step 3: Delete files
+    // Step 3: Copy files
+    if (!copy_files(plan.files_to_copy, result, progress_callback,
+                   current_progress, total_operations)) {
+        result.success = false;
+    }
+    
+    // Step 4: Delete files
     if (!delete_files(plan.files_to_delete, result, progress_callback,
                      current_progress, total_operations)) {
         result.success = false;
@@ -107,48 +152,14 @@ bool FileTinderExecutor::move_files(const std::vector<std::pair<QString, QString
             continue;
         }
         
-        QString dest_path = dest;
-        
-        // If dest is an existing directory or ends with separator, treat as directory
-        QFileInfo dest_info(dest);
-        if (dest_info.isDir() || dest.endsWith('/') || dest.endsWith('\\')) {
-            QDir dest_dir(dest);
-            if (!dest_dir.exists()) {
-                dest_dir.mkpath(".");
-            }
-            dest_path = dest_dir.absoluteFilePath(QFileInfo(source).fileName());
-        }
-        
-        // Handle existing file
-        if (QFile::exists(dest_path)) {
-            if (overwrite_existing_) {
-                QFile::remove(dest_path);
-            } else {
-                // Generate unique name with max attempts to prevent infinite loop
-                QString base = QFileInfo(dest_path).completeBaseName();
-                QString ext = QFileInfo(dest_path).suffix();
-                QString dir_path = QFileInfo(dest_path).absolutePath();
-                int counter = 1;
-                const int max_attempts = 10000;
-                while (QFile::exists(dest_path) && counter <= max_attempts) {
-                    if (ext.isEmpty()) {
-                        dest_path = QString("%1/%2_%3")
-                            .arg(dir_path, base, QString::number(counter));
-                    } else {
-                        dest_path = QString("%1/%2_%3.%4")
-                            .arg(dir_path, base, QString::number(counter), ext);
-                    }
-                    counter++;
-                }
-                if (counter > max_attempts) {
-                    result.errors++;
-                    result.error_messages.append(QString("Failed to generate unique name for: %1").arg(source));
-                    result.log.push_back({"move", source, "", false});
-                    all_success = false;
-                    progress++;
-                    continue;
-                }
-            }
+        QString dest_path;
+        if (!prepare_dest_path(source, dest, dest_path)) {
+            result.errors++;
+            result.error_messages.append(QString("Failed to generate unique name for: %1").arg(source));
+            result.log.push_back({"move", source, "", false});
+            all_success = false;
+            progress++;
+            continue;
         }
         
         if (QFile::rename(source, dest_path)) {
@@ -179,6 +190,76 @@ bool FileTinderExecutor::move_files(const std::vector<std::pair<QString, QString
     return all_success;
 }
 
+bool FileTinderExecutor::copy_files(const std::vector<std::pair<QString, QString>>& copies,
+                                    ExecutionResult& result,
+                                    ProgressCallback callback,
+                                    int& progress, int total) {
+    bool all_success = true;
+    
+    for (const auto& [source, dest] : copies) {
+        if (callback) {
+            callback(progress, total, QString("Copying: %1").arg(QFileInfo(source).fileName()));
+        }
+        
+        QString dest_path;
+        if (!QFile::exists(source)) {
+            result.errors++;
+            result.error_messages.append(QString("Source file no longer exists: %1").arg(source));
+            result.log.push_back({"copy", source, "", false});
+            all_success = false;
+        } else if (!prepare_dest_path(source, dest, dest_path)) {
+            result.errors++;
+            result.error_messages.append(QString("Failed to generate unique name for: %1").arg(source));
+            result.log.push_back({"copy", source, "", false});
+            all_success = false;
+        } else if (QFile::copy(source, dest_path)) {
+            result.files_copied++;
+            result.log.push_back({"copy", source, dest_path, true});
+        } else {
+            result.errors++;
+            result.error_messages.append(QString("Failed to copy: %1 to %2").arg(source, dest_path));
+            result.log.push_back({"copy", source, dest_path, false});
+            all_success = false;
+        }
+        
+        progress++;
+    }
+    
+    return all_success;
+}
+
+bool FileTinderExecutor::prepare_dest_path(const QString& source, const QString& dest, QString& dest_path) const {
+    dest_path = dest;
+    
+    // If dest is an existing directory or ends with separator, treat as directory
+    QFileInfo dest_info(dest);
+    if (dest_info.isDir() || dest.endsWith('/') || dest.endsWith('\\')) {
+        QDir dest_dir(dest);
+        if (!dest_dir.exists()) {
+            dest_dir.mkpath(".");
+        }
+        dest_path = dest_dir.absoluteFilePath(QFileInfo(source).fileName());
+    }
+    
+    // Handle existing file. A simulated plan has already picked a free name,
+    // so this only loops when the folder changed since the dry run.
+    if (!QFile::exists(dest_path)) return true;
+    if (overwrite_existing_) {
+        QFile::remove(dest_path);
+        return true;
+    }
+    // Generate unique name with max attempts to prevent infinite loop
+    QString base = QFileInfo(dest_path).completeBaseName();
+    QString ext = QFileInfo(dest_path).suffix();
+    QString dir_path = QFileInfo(dest_path).absolutePath();
+    int counter = 1;
+    while (QFile::exists(dest_path) && counter <= kMaxNameAttempts) {
+        dest_path = dir_path + "/" + numbered_name(base, ext, counter);
+        counter++;
+    }
+    return counter <= kMaxNameAttempts;
+}
+
 bool FileTinderExecutor::delete_files(const std::vector<QString>& files,
                                       ExecutionResult& result,
                                       ProgressCallback callback,
@@ -279,19 +360,12 @@ bool FileTinderExecutor::move_to_trash(const QString& file_path, QString& trash_
     QString base = QFileInfo(file_path).completeBaseName();
     QString ext = QFileInfo(file_path).suffix();
     int counter = 1;
-    const int max_attempts = 10000;
-    while (QFile::exists(dest) && counter <= max_attempts) {
-        QString candidate_name;
-        if (ext.isEmpty()) {
-            candidate_name = QString("%1_%2").arg(base, QString::number(counter));
-        } else {
-            candidate_name = QString("%1_%2.%3").arg(base, QString::number(counter), ext);
-        }
-        dest = trash_dir.absoluteFilePath(candidate_name);
+    while (QFile::exists(dest) && counter <= kMaxNameAttempts) {
+        dest = trash_dir.absoluteFilePath(numbered_name(base, ext, counter));
         counter++;
     }
     
-    if (counter > max_attempts) {
+    if (counter > kMaxNameAttempts) {
         return false;  // Failed to generate unique name
     }
     
@@ -306,6 +380,168 @@ bool FileTinderExecutor::move_to_trash(const QString& file_path, QString& trash_
 #endif
 }
 
+DryRunReport FileTinderExecutor::simulate(const ExecutionPlan& plan) const {
+    DryRunReport report;
+    QLocale locale;
+    qint64 estimated_us = 0;
+    
+    // Storage device per folder, from the closest existing ancestor
+    QHash<QString, int> device_index;     // Mount point -> report.devices
+    QHash<QString, QString> device_cache;  // Folder -> mount point
+    auto device_of = [&](const QString& folder) -> QString {
+        auto cached = device_cache.constFind(folder);
+        if (cached != device_cache.constEnd()) return *cached;
+        QStorageInfo storage(existing_ancestor(folder));
+        QString root = storage.isValid() ? storage.rootPath() : QString();
+        if (!root.isEmpty() && !device_index.contains(root)) {
+            device_index.insert(root, static_cast<int>(report.devices.size()));
+            DeviceEstimate device;
+            device.root = root;
+            device.bytes_available = storage.bytesAvailable();
+            report.devices.push_back(device);
+        }
+        device_cache.insert(folder, root);
+        return root;
+    };
+    
+    // Sources must be removable from their folder for moves and deletes
+    QHash<QString, bool> source_dir_writable;
+    auto check_source_dir = [&](const QFileInfo& source) {
+        QString dir = source.absolutePath();
+        if (source_dir_writable.contains(dir)) return;
+        bool writable = QFileInfo(dir).isWritable();
+        source_dir_writable.insert(dir, writable);
+        if (!writable) report.problems.append(QString("Cannot remove files from read-only folder: %1").arg(dir));
+    };
+    
+    QSet<QString> created;
+    for (const QString& folder : plan.folders_to_create) {
+        QString clean = QDir::cleanPath(folder);
+        created.insert(clean);
+        QString ancestor = existing_ancestor(clean);
+        if (!QFileInfo(ancestor).isDir() || !QFileInfo(ancestor).isWritable()) {
+            report.problems.append(QString("Cannot create folder %1: %2 is not writable").arg(folder, ancestor));
+        }
+    }
+    report.resolved_plan.folders_to_create = plan.folders_to_create;
+    
+    // Each destination folder is listed once; planned names are tracked
+    // next to the names already on disk
+    struct DestFolder {
+        QSet<QString> on_disk;
+        QSet<QString> planned;
+        QString device;
+    };
+    QHash<QString, DestFolder> dest_folders;
+    auto dest_folder = [&](const QString& path) -> DestFolder& {
+        auto it = dest_folders.find(path);
+        if (it != dest_folders.end()) return *it;
+        DestFolder folder;
+        QDir dir(path);
+        if (dir.exists()) {
+            const QStringList names = dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+            folder.on_disk.reserve(names.size());
+            for (const QString& name : names) folder.on_disk.insert(name_key(name));
+            if (!QFileInfo(path).isWritable()) {
+                report.problems.append(QString("Destination folder is read-only: %1").arg(path));
+            }
+        }
+        folder.device = device_of(path);
+        return *dest_folders.insert(path, folder);
+    };
+    
+    auto resolve = [&](const std::vector<std::pair<QString, QString>>& transfers, bool is_move,
+                       std::vector<std::pair<QString, QString>>& resolved) {
+        resolved.reserve(transfers.size());
+        for (const auto& [source, dest] : transfers) {
+            QFileInfo source_info(source);
+            if (!source_info.exists()) {
+                report.problems.append(QString("Source file no longer exists: %1").arg(source));
+                continue;
+            }
+            if (is_move) check_source_dir(source_info);
+            
+            // Same folder-vs-file rule as prepare_dest_path, counting folders
+            // the plan will create
+            QString clean_dest = QDir::cleanPath(dest);
+            bool into_folder = created.contains(clean_dest) || QFileInfo(dest).isDir() ||
+                               dest.endsWith('/') || dest.endsWith('\\');
+            QString dir_path = into_folder ? clean_dest : QFileInfo(dest).absolutePath();
+            QString name = into_folder ? source_info.fileName() : QFileInfo(dest).fileName();
+            DestFolder& folder = dest_folder(dir_path);
+            
+            QString key = name_key(name);
+            bool on_disk = folder.on_disk.contains(key);
+            if (folder.planned.contains(key) || (on_disk && !overwrite_existing_)) {
+                QString base = QFileInfo(name).completeBaseName();
+                QString ext = QFileInfo(name).suffix();
+                int counter = 1;
+                for (; counter <= kMaxNameAttempts; ++counter) {
+                    name = numbered_name(base, ext, counter);
+                    key = name_key(name);
+                    if (!folder.planned.contains(key) && !folder.on_disk.contains(key)) break;
+                }
+                if (counter > kMaxNameAttempts) {
+                    report.problems.append(QString("Failed to generate unique name for: %1").arg(source));
+                    continue;
+                }
+                report.renamed++;
+            } else if (on_disk) {
+                report.warnings.append(QString("Will overwrite: %1/%2").arg(dir_path, name));
+            }
+            folder.planned.insert(key);
+            resolved.push_back({source, dir_path + "/" + name});
+            
+            // Copies and moves between devices write the whole file
+            bool cross_device = !is_move || device_of(source_info.absolutePath()) != folder.device;
+            if (!cross_device) {
+                estimated_us += kRenameCostUs;
+                continue;
+            }
+            if (is_move) report.cross_device++;
+            qint64 bytes = source_info.size();
+            report.bytes_to_copy += bytes;
+            estimated_us += kRenameCostUs + bytes * 1000000 / kCopyBytesPerSec;
+            auto device = device_index.constFind(folder.device);
+            if (device != device_index.constEnd()) {
+                report.devices[*device].bytes_to_write += bytes;
+                report.devices[*device].files++;
+            }
+        }
+    };
+    resolve(plan.files_to_move, true, report.resolved_plan.files_to_move);
+    resolve(plan.files_to_copy, false, report.resolved_plan.files_to_copy);
+    
+    report.resolved_plan.files_to_delete.reserve(plan.files_to_delete.size());
+    for (const QString& path : plan.files_to_delete) {
+        QFileInfo info(path);
+        if (!info.exists()) {
+            report.problems.append(QString("File no longer exists (already deleted?): %1").arg(path));
+            continue;
+        }
+        check_source_dir(info);
+        report.resolved_plan.files_to_delete.push_back(path);
+        estimated_us += use_trash_ ? kTrashCostUs : kRenameCostUs;
+    }
+    
+    for (const DeviceEstimate& device : report.devices) {
+        if (device.bytes_available >= 0 && device.bytes_to_write > device.bytes_available) {
+            report.problems.append(QString("Not enough space on %1: %2 to write, %3 free")
+                .arg(device.root, locale.formattedDataSize(device.bytes_to_write),
+                     locale.formattedDataSize(device.bytes_available)));
+        }
+    }
+    if (report.renamed > 0) {
+        report.warnings.append(QString("%1 file(s) will get a numbered name to avoid overwriting").arg(report.renamed));
+    }
+    if (report.cross_device > 0) {
+        report.warnings.append(QString("%1 move(s) cross devices and will be copied, then removed")
+            .arg(report.cross_device));
+    }
+    report.estimated_ms = estimated_us / 1000;
+    return report;
+}
+
 bool FileTinderExecutor::undo_action(const ExecutionLogEntry& entry) {
     if (!entry.success) return false;
     
@@ -347,6 +583,12 @@ bool FileTinderExecutor::undo_action(const ExecutionLogEntry& entry) {
         return false;
     }
     
+    if (entry.action == "copy") {
+        // Remove the copy; the original never moved
+        if (entry.dest_path.isEmpty() || !QFile::exists(entry.dest_path)) return false;
+        return QFile::remove(entry.dest_path);
+    }
+    
     if (entry.action == "folder_create") {
         // Remove empty folder (only if it's now empty)
         QDir dir(entry.source_path);
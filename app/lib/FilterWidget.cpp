@@ -137,6 +137,13 @@ void FilterWidget::setup_ui() {
     include_folders_check_ = new QCheckBox("Include Folders");
     layout->addWidget(include_folders_check_);
 
+    // Query box, applied on top of the category filter
+    query_edit_ = new QLineEdit();
+    query_edit_->setPlaceholderText("Query: type:video size>2GB age>2y");
+    query_edit_->setMinimumWidth(200);
+    set_query_error(QString());
+    layout->addWidget(query_edit_, 1);
+
     // Spacer
     layout->addSpacing(16);
 
@@ -170,6 +177,27 @@ void FilterWidget::setup_ui() {
             this, &FilterWidget::on_sort_order_toggled);
     connect(include_folders_check_, &QCheckBox::toggled,
             this, &FilterWidget::on_include_folders_toggled);
+    connect(query_edit_, &QLineEdit::returnPressed, this, [this]() {
+        emit query_changed(query_edit_->text());
+    });
+    connect(query_edit_, &QLineEdit::textChanged, this, [this](const QString& text) {
+        if (text.isEmpty()) emit query_changed(text);
+    });
+}
+
+QString FilterWidget::get_query_text() const {
+    return query_edit_->text();
+}
+
+void FilterWidget::set_query_error(const QString& error) {
+    if (error.isEmpty()) {
+        query_edit_->setStyleSheet(QString());
+        query_edit_->setToolTip("Fields: size, age, modified, type, ext, name, decision, is:duplicate.\n"
+                                "Terms are ANDed; use 'or', '-' and parentheses to combine. Enter to apply.");
+    } else {
+        query_edit_->setStyleSheet("QLineEdit { border: 1px solid #e74c3c; }");
+        query_edit_->setToolTip(error);
+    }
 }
 
 void FilterWidget::on_filter_changed(int index) {
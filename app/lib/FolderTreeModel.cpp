@@ -4,10 +4,18 @@
 #include <QFileInfo>
 #include <QIcon>
 
+// Coalescing window for count signals, about one frame
+static const int kCountFlushMs = 16;
+
 FolderTreeModel::FolderTreeModel(QObject* parent)
     : QAbstractItemModel(parent)
     , root_(std::make_unique<FolderNode>())
-    , next_connection_group_id_(1) {
+    , next_connection_group_id_(1)
+    , count_flush_timer_(new QTimer(this)) {
+    path_index_.insert(root_->path, root_.get());
+    count_flush_timer_->setSingleShot(true);
+    count_flush_timer_->setInterval(kCountFlushMs);
+    connect(count_flush_timer_, &QTimer::timeout, this, &FolderTreeModel::flush_count_changes);
 }
 
 FolderTreeModel::~FolderTreeModel() = default;
@@ -133,6 +141,8 @@ void FolderTreeModel::set_root_folder(const QString& path) {
         root_->display_name = path;
     }
     root_->exists = QDir(path).exists();
+    path_index_.clear();
+    path_index_.insert(root_->path, root_.get());
     
     // Start with root only — destination folders are added manually via
     // the "+" button (Create New Folder or Add Existing Folder).
@@ -141,26 +151,6 @@ void FolderTreeModel::set_root_folder(const QString& path) {
     emit folder_structure_changed();
 }
 
-void FolderTreeModel::scan_directory(FolderNode* parent, const QString& path, int depth) {
-    if (depth > 3) return; // Limit depth
-    
-    QDir dir(path);
-    QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
-    
-    for (const QString& subdir : subdirs) {
-        auto child = std::make_unique<FolderNode>();
-        child->path = dir.absoluteFilePath(subdir);
-        child->display_name = subdir;
-        child->exists = true;
-        child->parent = parent;
-        
-        // Recursively scan subdirectories
-        scan_directory(child.get(), child->path, depth + 1);
-        
-        parent->children.push_back(std::move(child));
-    }
-}
-
 void FolderTreeModel::add_folder(const QString& path, bool virtual_folder) {
     // Find parent folder
     QString parent_path = QFileInfo(path).absolutePath();
@@ -186,6 +176,7 @@ void FolderTreeModel::add_folder(const QString& path, bool virtual_folder) {
     child->exists = !virtual_folder && QDir(path).exists();
     child->is_external = !path.startsWith(root_->path);
     child->parent = parent_node;
+    path_index_.insert(path, child.get());
     
     parent_node->children.push_back(std::move(child));
     
@@ -214,6 +205,7 @@ void FolderTreeModel::remove_folder(const QString& path) {
     if (row < 0) return;
     
     beginRemoveRows(parent_index, row, row);
+    unindex_subtree(node);
     parent->children.erase(parent->children.begin() + row);
     endRemoveRows();
     
@@ -262,9 +254,7 @@ void FolderTreeModel::assign_file_to_folder(const QString& folder_path) {
     FolderNode* node = find_node(folder_path);
     if (node) {
         node->assigned_file_count++;
-        QModelIndex idx = index_for_node(node);
-        emit dataChanged(idx, idx, {FileCountRole});
-        emit folder_assigned(folder_path);
+        note_count_change(node, 1);
     }
 }
 
@@ -272,9 +262,45 @@ void FolderTreeModel::unassign_file_from_folder(const QString& folder_path) {
     FolderNode* node = find_node(folder_path);
     if (node && node->assigned_file_count > 0) {
         node->assigned_file_count--;
+        note_count_change(node, -1);
+    }
+}
+
+void FolderTreeModel::apply_assignment_deltas(const QHash<QString, int>& deltas) {
+    for (auto it = deltas.constBegin(); it != deltas.constEnd(); ++it) {
+        if (it.value() == 0) continue;
+        FolderNode* node = find_node(it.key());
+        if (!node) continue;
+        int before = node->assigned_file_count;
+        node->assigned_file_count = qMax(0, before + it.value());
+        note_count_change(node, node->assigned_file_count - before);
+    }
+}
+
+void FolderTreeModel::note_count_change(FolderNode* node, int delta) {
+    if (delta == 0) return;
+    pending_count_deltas_[node->path] += delta;
+    if (!count_flush_timer_->isActive()) count_flush_timer_->start();
+}
+
+void FolderTreeModel::flush_count_changes() {
+    count_flush_timer_->stop();
+    if (pending_count_deltas_.isEmpty()) return;
+
+    QHash<QString, int> deltas;
+    deltas.swap(pending_count_deltas_);
+    QStringList changed;
+    for (auto it = deltas.constBegin(); it != deltas.constEnd(); ++it) {
+        // Assign then unassign within one frame nets out; nothing to repaint
+        if (it.value() == 0) continue;
+        FolderNode* node = find_node(it.key());
+        if (!node) continue;  // Removed before the flush
         QModelIndex idx = index_for_node(node);
         emit dataChanged(idx, idx, {FileCountRole});
+        if (it.value() > 0) emit folder_assigned(it.key());
+        changed.append(it.key());
     }
+    if (!changed.isEmpty()) emit folder_counts_changed(changed);
 }
 
 void FolderTreeModel::clear_assignments() {
@@ -285,7 +311,10 @@ void FolderTreeModel::clear_assignments() {
         }
     };
     clear_recursive(root_.get());
+    pending_count_deltas_.clear();
+    count_flush_timer_->stop();
     emit dataChanged(QModelIndex(), QModelIndex());
+    emit folder_counts_changed(path_index_.keys());
 }
 
 FolderNode* FolderTreeModel::node_at(const QModelIndex& index) const {
@@ -296,22 +325,16 @@ FolderNode* FolderTreeModel::node_at(const QModelIndex& index) const {
 }
 
 FolderNode* FolderTreeModel::find_node(const QString& path) const {
-    return find_node_recursive(root_.get(), path);
+    return path_index_.value(path, nullptr);
 }
 
-FolderNode* FolderTreeModel::find_node_recursive(FolderNode* node, const QString& path) const {
-    if (node->path == path) {
-        return node;
-    }
-    
+void FolderTreeModel::unindex_subtree(FolderNode* node) {
+    // Only drop entries that point at this node; a duplicate path elsewhere keeps its own
+    auto it = path_index_.find(node->path);
+    if (it != path_index_.end() && it.value() == node) path_index_.erase(it);
     for (const auto& child : node->children) {
-        FolderNode* found = find_node_recursive(child.get(), path);
-        if (found) {
-            return found;
-        }
+        unindex_subtree(child.get());
     }
-    
-    return nullptr;
 }
 
 QModelIndex FolderTreeModel::index_for_path(const QString& path) const {
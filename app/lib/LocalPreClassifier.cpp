@@ -0,0 +1,111 @@
+#include "LocalPreClassifier.hpp"
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+QStringList LocalPreClassifier::features(const QString& file_name, const QString& mime_type) {
+    QStringList out;
+    QFileInfo info(file_name);
+    QString base = info.completeBaseName().toLower();
+    QString ext = info.suffix().toLower();
+
+    // Split on separators and letter/digit boundaries; digit runs collapse
+    // to their length so IMG_1234 and IMG_5678 share a feature
+    QStringList tokens;
+    QString current;
+    auto flush = [&]() {
+        if (current.isEmpty()) return;
+        if (current[0].isDigit()) tokens.append(QString("#%1").arg(std::min<qsizetype>(current.size(), 8)));
+        else if (current.size() > 1) tokens.append(current);
+        current.clear();
+    };
+    for (QChar c : base) {
+        if (!c.isLetterOrNumber()) {
+            flush();
+            continue;
+        }
+        if (!current.isEmpty() && current[0].isDigit() != c.isDigit()) flush();
+        current += c;
+    }
+    flush();
+
+    for (int i = 0; i < tokens.size(); ++i) {
+        out.append("w:" + tokens[i]);
+        if (i + 1 < tokens.size()) out.append("b:" + tokens[i] + "+" + tokens[i + 1]);
+    }
+    if (!tokens.isEmpty()) out.append("first:" + tokens.first());
+    if (!ext.isEmpty()) out.append("ext:" + ext);
+    if (!mime_type.isEmpty()) {
+        out.append("mime:" + mime_type);
+        out.append("mcat:" + mime_type.section('/', 0, 0));
+    }
+    return out;
+}
+
+void LocalPreClassifier::add_example(const QString& file_name, const QString& mime_type, const QString& folder) {
+    if (folder.isEmpty()) return;
+    if (!folders_.contains(folder) && (allowed_.isEmpty() || allowed_.contains(folder))) ++allowed_known_;
+    FolderStats& stats = folders_[folder];
+    ++stats.examples;
+    ++total_examples_;
+    for (const QString& feature : features(file_name, mime_type)) {
+        ++stats.feature_counts[feature];
+        ++stats.feature_total;
+        ++vocabulary_[feature];
+    }
+}
+
+void LocalPreClassifier::set_allowed_folders(const QStringList& folders) {
+    allowed_ = folders;
+    allowed_known_ = 0;
+    for (auto it = folders_.constBegin(); it != folders_.constEnd(); ++it) {
+        if (allowed_.isEmpty() || allowed_.contains(it.key())) ++allowed_known_;
+    }
+}
+
+PreClassification LocalPreClassifier::classify(const QString& file_name, const QString& mime_type) const {
+    PreClassification result;
+    if (total_examples_ == 0) return result;
+
+    // Features never seen in training carry no evidence either way
+    QStringList feats;
+    for (const QString& feature : features(file_name, mime_type)) {
+        if (vocabulary_.contains(feature)) feats.append(feature);
+    }
+    if (feats.isEmpty()) return result;
+
+    const double vocab = static_cast<double>(vocabulary_.size());
+    std::vector<std::pair<double, QString>> scores;
+    for (auto it = folders_.constBegin(); it != folders_.constEnd(); ++it) {
+        if (!allowed_.isEmpty() && !allowed_.contains(it.key())) continue;
+        const FolderStats& stats = it.value();
+        double log_p = std::log(static_cast<double>(stats.examples) / total_examples_);
+        for (const QString& feature : feats) {
+            // Laplace smoothing
+            double count = stats.feature_counts.value(feature, 0);
+            log_p += std::log((count + 1.0) / (stats.feature_total + vocab));
+        }
+        scores.emplace_back(log_p, it.key());
+    }
+    if (scores.empty()) return result;
+
+    std::sort(scores.begin(), scores.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    // Normalise with log-sum-exp
+    double max_log = scores.front().first;
+    double sum = 0.0;
+    for (const auto& s : scores) sum += std::exp(s.first - max_log);
+
+    result.folder = scores.front().second;
+    result.confidence = 1.0 / sum;
+    result.support = folders_.value(result.folder).examples;
+    for (size_t i = 1; i < scores.size() && i < 3; ++i) result.alternates.append(scores[i].second);
+    return result;
+}
+
+bool LocalPreClassifier::is_confident(const PreClassification& result) const {
+    return !result.folder.isEmpty()
+        && result.confidence >= kAcceptConfidence
+        && result.support >= kMinSupport
+        && allowed_known_ >= 2;  // One candidate folder says nothing about the choice
+}
@@ -0,0 +1,267 @@
+#include "MindMapSceneView.hpp"
+#include "MindMapView.hpp"
+#include "FolderTreeModel.hpp"
+#include <QGraphicsScene>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QApplication>
+#include <QSet>
+#include <algorithm>
+
+namespace {
+    struct CellPalette {
+        QColor fill;
+        QColor border;
+        QColor text;
+        qreal border_width;
+        bool dashed;
+        bool bold;
+    };
+
+    // Same colours as the widget grid's stylesheet
+    CellPalette palette_for(const QString& state, const QColor& custom) {
+        if (state == "selected") return {QColor("#1a3a5c"), QColor("#3498db"), QColor("#3498db"), 2.0, false, true};
+        if (state == "root") return {QColor("#1a252f"), QColor("#3498db"), QColor("#3498db"), 2.0, false, true};
+        if (state == "custom") return {custom.darker(300), custom, custom, 1.0, false, false};
+        if (state == "virtual") return {QColor("#3a3520"), QColor("#f39c12"), QColor("#f39c12"), 1.0, true, false};
+        if (state == "external") return {QColor("#2d1f3d"), QColor("#9b59b6"), QColor("#bb6bd9"), 1.0, false, false};
+        if (state == "add") return {QColor("#27ae60"), QColor("#27ae60"), QColor("white"), 1.0, false, true};
+        return {QColor("#34495e"), QColor("#4a6078"), QColor("#ecf0f1"), 1.0, false, false};
+    }
+
+    // Below this scale captions are unreadable anyway; draw plain cells
+    constexpr qreal kTextLevelOfDetail = 0.35;
+}
+
+// === FolderMapItem ===
+
+FolderMapItem::FolderMapItem(const QString& path, const QSizeF& size)
+    : path_(path)
+    , size_(size) {
+    text_.setTextFormat(Qt::PlainText);
+    setToolTip(path);
+}
+
+QRectF FolderMapItem::boundingRect() const {
+    return QRectF(QPointF(0, 0), size_).adjusted(-1, -1, 1, 1);
+}
+
+void FolderMapItem::set_size(const QSizeF& size) {
+    if (size == size_) return;
+    prepareGeometryChange();
+    size_ = size;
+}
+
+void FolderMapItem::set_content(const QString& label, const QString& state, const QString& custom_color, int font_px) {
+    QColor custom = custom_color.isEmpty() ? QColor() : QColor(custom_color);
+    if (label == label_ && state == state_ && custom == custom_color_ && font_px == font_px_) return;
+    if (label != label_) {
+        label_ = label;
+        text_.setText(label);
+    }
+    state_ = state;
+    custom_color_ = custom;
+    font_px_ = font_px;
+    prepare_text();
+    update();
+}
+
+void FolderMapItem::set_selected(bool selected) {
+    if (selected == selected_) return;
+    selected_ = selected;
+    prepare_text();
+    update();
+}
+
+void FolderMapItem::set_label(const QString& label) {
+    if (label == label_) return;
+    label_ = label;
+    text_.setText(label);
+    prepare_text();
+    update();
+}
+
+void FolderMapItem::prepare_text() {
+    QFont font;
+    font.setPixelSize(font_px_);
+    font.setBold(palette_for(selected_ ? QString("selected") : state_, custom_color_).bold);
+    font_ = font;
+    text_.prepare(QTransform(), font_);
+}
+
+void FolderMapItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    CellPalette palette = palette_for(selected_ ? QString("selected") : state_, custom_color_);
+    QRectF rect(QPointF(0, 0), size_);
+    qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+
+    if (lod < kTextLevelOfDetail) {
+        painter->fillRect(rect, palette.border);
+        return;
+    }
+
+    QPen pen(palette.border, palette.border_width, palette.dashed ? Qt::DashLine : Qt::SolidLine);
+    painter->setPen(pen);
+    painter->setBrush(palette.fill);
+    qreal inset = palette.border_width / 2.0;
+    painter->drawRoundedRect(rect.adjusted(inset, inset, -inset, -inset), 4, 4);
+
+    // Layout is cached in the QStaticText and redone only when font or text change
+    painter->setFont(font_);
+    painter->setPen(palette.text);
+    QSizeF text_size = text_.size();
+    QPointF origin((size_.width() - text_size.width()) / 2.0, (size_.height() - text_size.height()) / 2.0);
+    // The view skips saving painter state per item, so the clip must not leak
+    painter->save();
+    painter->setClipRect(rect.adjusted(4, 0, -4, 0));
+    painter->drawStaticText(origin, text_);
+    painter->restore();
+}
+
+// === MindMapSceneView ===
+
+MindMapSceneView::MindMapSceneView(QWidget* parent)
+    : QGraphicsView(parent)
+    , scene_(new QGraphicsScene(this)) {
+    scene_->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+    setScene(scene_);
+    setBackgroundBrush(QColor("#2c3e50"));
+    setFrameShape(QFrame::NoFrame);
+    setRenderHint(QPainter::Antialiasing);
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
+}
+
+QPointF MindMapSceneView::cell_origin(int row, int col) const {
+    return QPointF(kMargin + col * (cell_size_.width() + kCellSpacing),
+                   kMargin + row * (cell_size_.height() + kCellSpacing));
+}
+
+void MindMapSceneView::sync(FolderNode* root, const std::vector<FolderNode*>& nodes,
+                            const QMap<QString, QPair<int, int>>& cells, int root_rows,
+                            QPair<int, int> add_cell, const QSizeF& cell_size, bool show_full_paths, int root_font_px) {
+    cell_size_ = cell_size;
+
+    QSet<QString> seen;
+    auto place = [&](FolderNode* node, bool is_root) {
+        FolderMapItem* item = items_.value(node->path);
+        if (!item) {
+            item = new FolderMapItem(node->path, cell_size_);
+            scene_->addItem(item);
+            items_.insert(node->path, item);
+        }
+        item->set_size(cell_size_);
+        item->set_content(FolderButton::label_for(node, show_full_paths, static_cast<int>(cell_size_.width())),
+                          FolderButton::state_for(node, false, is_root), node->custom_color,
+                          is_root ? root_font_px : 10);
+        item->set_selected(node->path == selected_path_);
+        seen.insert(node->path);
+        return item;
+    };
+
+    for (FolderNode* node : nodes) {
+        QPair<int, int> cell = cells.value(node->path);
+        place(node, false)->setPos(cell_origin(cell.first, cell.second));
+    }
+    // Root is centred over the rows its children use
+    FolderMapItem* root_item = place(root, true);
+    qreal span = root_rows * (cell_size_.height() + kCellSpacing) - kCellSpacing;
+    root_item->setPos(cell_origin(0, 0) + QPointF(0, (span - cell_size_.height()) / 2.0));
+
+    for (auto it = items_.begin(); it != items_.end();) {
+        if (seen.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        scene_->removeItem(it.value());
+        delete it.value();
+        it = items_.erase(it);
+    }
+
+    if (!add_item_) {
+        add_item_ = new FolderMapItem(QString(), QSizeF(cell_size_.height(), cell_size_.height()));
+        add_item_->set_content("+", "add", QString(), 14);
+        add_item_->setToolTip("Add folder");
+        scene_->addItem(add_item_);
+    }
+    add_item_->set_size(QSizeF(cell_size_.height(), cell_size_.height()));
+    add_item_->setPos(cell_origin(add_cell.first, add_cell.second));
+
+    scene_->setSceneRect(scene_->itemsBoundingRect().adjusted(-kMargin, -kMargin, kMargin, kMargin));
+}
+
+void MindMapSceneView::set_selected_path(const QString& path) {
+    if (path == selected_path_) return;
+    if (FolderMapItem* old_item = items_.value(selected_path_)) old_item->set_selected(false);
+    selected_path_ = path;
+    if (FolderMapItem* item = items_.value(path)) item->set_selected(true);
+}
+
+void MindMapSceneView::update_label(const QString& path, const QString& label) {
+    if (FolderMapItem* item = items_.value(path)) item->set_label(label);
+}
+
+void MindMapSceneView::ensure_path_visible(const QString& path) {
+    if (FolderMapItem* item = items_.value(path)) ensureVisible(item);
+}
+
+void MindMapSceneView::zoom_by(double factor) {
+    double current = transform().m11();
+    double target = std::clamp(current * factor, kMinZoom, kMaxZoom);
+    if (qFuzzyCompare(target, current)) return;
+    scale(target / current, target / current);
+}
+
+void MindMapSceneView::zoom_fit() {
+    QRectF bounds = scene_->itemsBoundingRect();
+    if (bounds.isEmpty()) return;
+    fitInView(bounds.adjusted(-kMargin, -kMargin, kMargin, kMargin), Qt::KeepAspectRatio);
+    // Never blow a small map up past 1:1
+    double current = transform().m11();
+    double target = std::clamp(current, kMinZoom, 1.0);
+    if (!qFuzzyCompare(target, current)) scale(target / current, target / current);
+}
+
+void MindMapSceneView::wheelEvent(QWheelEvent* event) {
+    if (event->modifiers() & Qt::ControlModifier) {
+        zoom_by(event->angleDelta().y() > 0 ? 1.15 : 1.0 / 1.15);
+        event->accept();
+        return;
+    }
+    QGraphicsView::wheelEvent(event);
+}
+
+void MindMapSceneView::mousePressEvent(QMouseEvent* event) {
+    press_pos_ = event->pos();
+    QGraphicsView::mousePressEvent(event);
+}
+
+void MindMapSceneView::mouseReleaseEvent(QMouseEvent* event) {
+    QGraphicsView::mouseReleaseEvent(event);
+    // A press and release in place is a click; anything longer was a pan
+    if (event->button() != Qt::LeftButton
+        || (event->pos() - press_pos_).manhattanLength() >= QApplication::startDragDistance()) return;
+    FolderMapItem* item = item_at(event->pos());
+    if (!item) return;
+    if (item == add_item_) emit add_folder_requested();
+    else emit folder_clicked(item->path());
+}
+
+void MindMapSceneView::contextMenuEvent(QContextMenuEvent* event) {
+    FolderMapItem* item = item_at(event->pos());
+    if (item && item != add_item_) {
+        emit folder_context_menu(item->path(), event->globalPos());
+        event->accept();
+        return;
+    }
+    QGraphicsView::contextMenuEvent(event);
+}
+
+FolderMapItem* MindMapSceneView::item_at(const QPoint& view_pos) const {
+    return dynamic_cast<FolderMapItem*>(itemAt(view_pos));
+}
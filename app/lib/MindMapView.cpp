@@ -1,5 +1,6 @@
 #include "MindMapView.hpp"
 #include "FolderTreeModel.hpp"
+#include "MindMapSceneView.hpp"
 #include "ui_constants.hpp"
 #include <QContextMenuEvent>
 #include <QMouseEvent>
@@ -9,12 +10,37 @@
 #include <QDragEnterEvent>
 #include <QDropEvent>
 #include <QFileInfo>
+#include <QStyle>
+#include <QSettings>
+#include <QVBoxLayout>
+
+// One stylesheet for the whole grid, keyed on the folderState property,
+// so adding a button does not parse a sheet of its own
+static QString folder_grid_style(int root_font_px) {
+    return QString(
+        "#mindMapContent { background-color: #2c3e50; }"
+        "FolderButton { text-align: center; padding: 2px 6px; border-radius: 4px; font-size: 10px; "
+        "background-color: #34495e; border: 1px solid #4a6078; color: #ecf0f1; }"
+        "FolderButton:hover { background-color: #3d566e; border-color: #5a7a98; }"
+        "FolderButton[folderState=\"selected\"] { background-color: #1a3a5c; border: 2px solid #3498db; "
+        "color: #3498db; font-weight: bold; }"
+        "FolderButton[folderState=\"selected\"]:hover { background-color: #1e4a6e; }"
+        "FolderButton[folderState=\"root\"] { background-color: #1a252f; border: 2px solid #3498db; "
+        "color: #3498db; font-weight: bold; font-size: %1px; }"
+        "FolderButton[folderState=\"root\"]:hover { background-color: #1e2f3d; }"
+        "FolderButton[folderState=\"virtual\"] { background-color: #3a3520; border: 1px dashed #f39c12; color: #f39c12; }"
+        "FolderButton[folderState=\"virtual\"]:hover { background-color: #4a4530; }"
+        "FolderButton[folderState=\"external\"] { background-color: #2d1f3d; border: 1px solid #9b59b6; color: #bb6bd9; }"
+        "FolderButton[folderState=\"external\"]:hover { background-color: #3d2f4d; }"
+    ).arg(root_font_px);
+}
 
 // === FolderButton Implementation ===
 
 FolderButton::FolderButton(FolderNode* node, QWidget* parent)
     : QPushButton(parent)
     , node_(node)
+    , path_(node->path)
     , is_selected_(false) {
     setCursor(Qt::PointingHandCursor);
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
@@ -23,14 +49,14 @@ FolderButton::FolderButton(FolderNode* node, QWidget* parent)
     update_style();
     
     connect(this, &QPushButton::clicked, this, [this]() {
-        emit folder_clicked(node_->path);
+        emit folder_clicked(path_);
     });
 }
 
-void FolderButton::update_display() {
+QString FolderButton::label_for(const FolderNode* node, bool show_full_path, int width_px) {
     QString name;
-    if (show_full_path_) {
-        name = node_->path;
+    if (show_full_path) {
+        name = node->path;
         QStringList parts = name.split(QDir::separator());
         if (parts.size() <= 2) parts = name.split('/');  // fallback for stored paths
         if (parts.size() > 2) {
@@ -38,25 +64,37 @@ void FolderButton::update_display() {
         }
         // For single-component paths, just use the full path as-is
     } else {
-        name = node_->display_name;
+        name = node->display_name;
         if (name.isEmpty()) {
-            name = QFileInfo(node_->path).fileName();
+            name = QFileInfo(node->path).fileName();
         }
     }
     
     // Compact display: name + count
     QString count_str;
-    if (node_->assigned_file_count > 0) {
-        count_str = QString(" (%1)").arg(node_->assigned_file_count);
+    if (node->assigned_file_count > 0) {
+        count_str = QString(" (%1)").arg(node->assigned_file_count);
     }
     
     // Truncate long names to fit button width (~9px per character at font-size 10px)
-    int max_len = qMax(8, width() / 9);
+    int max_len = qMax(8, width_px / 9);
     if (name.length() > max_len) {
         name = name.left(max_len - 1) + "…";
     }
-    
-    setText(name + count_str);
+    return name + count_str;
+}
+
+QString FolderButton::state_for(const FolderNode* node, bool selected, bool root) {
+    if (selected) return "selected";
+    if (root) return "root";
+    if (!node->custom_color.isEmpty()) return "custom";
+    if (!node->exists) return "virtual";
+    if (node->is_external) return "external";
+    return "normal";
+}
+
+void FolderButton::update_display() {
+    setText(label_for(node_, show_full_path_, width()));
     setToolTip(node_->path);
 }
 
@@ -65,50 +103,43 @@ void FolderButton::set_selected(bool selected) {
     update_style();
 }
 
+void FolderButton::set_root(bool root) {
+    is_root_ = root;
+    update_style();
+}
+
+void FolderButton::refresh_appearance() {
+    update_display();
+    update_style();
+}
+
 void FolderButton::update_style() {
-    if (is_selected_) {
-        setStyleSheet(
-            "QPushButton { text-align: center; padding: 2px 6px; "
-            "background-color: #1a3a5c; border: 2px solid #3498db; "
-            "border-radius: 4px; color: #3498db; font-weight: bold; font-size: 10px; }"
-            "QPushButton:hover { background-color: #1e4a6e; }"
-        );
-    } else if (!node_->custom_color.isEmpty()) {
+    QString state = state_for(node_, is_selected_, is_root_);
+
+    if (state == "custom") {
         // User-assigned custom color
         QColor c(node_->custom_color);
         QColor bg = c.darker(300);
-        setStyleSheet(QString(
+        QString sheet = QString(
             "QPushButton { text-align: center; padding: 2px 6px; "
             "background-color: %1; border: 1px solid %2; "
             "border-radius: 4px; color: %2; font-size: 10px; }"
             "QPushButton:hover { background-color: %3; }"
-        ).arg(bg.name(), c.name(), bg.lighter(120).name()));
-    } else if (!node_->exists) {
-        setStyleSheet(
-            "QPushButton { text-align: center; padding: 2px 6px; "
-            "background-color: #3a3520; border: 1px dashed #f39c12; "
-            "border-radius: 4px; color: #f39c12; font-size: 10px; }"
-            "QPushButton:hover { background-color: #4a4530; }"
-        );
-    } else if (node_->is_external) {
-        setStyleSheet(
-            "QPushButton { text-align: center; padding: 2px 6px; "
-            "background-color: #2d1f3d; border: 1px solid #9b59b6; "
-            "border-radius: 4px; color: #bb6bd9; font-size: 10px; }"
-            "QPushButton:hover { background-color: #3d2f4d; }"
-        );
-    } else {
-        setStyleSheet(
-            "QPushButton { text-align: center; padding: 2px 6px; "
-            "background-color: #34495e; border: 1px solid #4a6078; "
-            "border-radius: 4px; color: #ecf0f1; font-size: 10px; }"
-            "QPushButton:hover { background-color: #3d566e; border-color: #5a7a98; }"
-        );
+        ).arg(bg.name(), c.name(), bg.lighter(120).name());
+        if (styleSheet() != sheet) setStyleSheet(sheet);
+    } else if (!styleSheet().isEmpty()) {
+        setStyleSheet(QString());
     }
+
+    if (state == style_state_) return;
+    style_state_ = state;
+    setProperty("folderState", state);
+    style()->unpolish(this);
+    style()->polish(this);
 }
 
 void FolderButton::contextMenuEvent(QContextMenuEvent* event) {
-    emit folder_right_clicked(node_->path, event->globalPos());
+    emit folder_right_clicked(path_, event->globalPos());
     event->accept();
 }
 
@@ -125,7 +156,7 @@ void FolderButton::mouseMoveEvent(QMouseEvent* event) {
     
     auto* drag = new QDrag(this);
     auto* mime = new QMimeData();
-    mime->setText(node_->path);
+    mime->setText(path_);
     drag->setMimeData(mime);
     drag->exec(Qt::MoveAction);
 }
@@ -139,8 +170,11 @@ MindMapView::MindMapView(QWidget* parent)
     , grid_layout_(nullptr)
     , model_(nullptr)
     , add_button_(nullptr)
+    , refresh_timer_(new QTimer(this))
     , next_row_(0)
     , next_col_(0) {
+    refresh_timer_->setSingleShot(true);
+    connect(refresh_timer_, &QTimer::timeout, this, &MindMapView::refresh_layout);
     
     auto* outer_layout = new QVBoxLayout(this);
     outer_layout->setContentsMargins(0, 0, 0, 0);
@@ -153,6 +187,7 @@ MindMapView::MindMapView(QWidget* parent)
     
     setAcceptDrops(true);
     setMinimumHeight(ui::scaling::scaled(120));
+    prefer_scene_ = QSettings("FileTinder", "FileTinder").value("mindMap/sceneRenderer", false).toBool();
 }
 
 MindMapView::~MindMapView() = default;
@@ -161,35 +196,48 @@ void MindMapView::set_model(FolderTreeModel* model) {
     model_ = model;
     
     if (model_) {
+        // AI auto-apply and folder loading add many folders in a row; lay out once
         connect(model_, &FolderTreeModel::folder_structure_changed, 
-                this, &MindMapView::refresh_layout);
+                this, &MindMapView::schedule_refresh);
+        connect(model_, &FolderTreeModel::folder_counts_changed,
+                this, &MindMapView::update_folder_counts);
         
         refresh_layout();
     }
 }
 
-void MindMapView::refresh_layout() {
+void MindMapView::schedule_refresh() {
+    drop_stale_buttons();
+    if (!refresh_timer_->isActive()) refresh_timer_->start(0);
+}
+
+void MindMapView::drop_stale_buttons() {
+    // Buttons hold raw node pointers; drop the ones whose node was removed or
+    // replaced now, so nothing touches them before the deferred relayout
     if (!model_) return;
-    
-    // Clear existing
-    buttons_.clear();
-    add_button_ = nullptr;
-    grid_positions_.clear();
-    next_row_ = 0;
-    next_col_ = 0;
-    
-    // Create new content widget
+    for (auto it = buttons_.begin(); it != buttons_.end();) {
+        if (model_->find_node(it.key()) == it.value()->node()) {
+            ++it;
+            continue;
+        }
+        FolderButton* stale = it.value();
+        if (grid_layout_) grid_layout_->removeWidget(stale);
+        grid_positions_.remove(it.key());
+        stale->hide();
+        stale->deleteLater();
+        it = buttons_.erase(it);
+    }
+}
+
+void MindMapView::ensure_content_widget() {
+    if (content_widget_) return;
     content_widget_ = new QWidget();
-    content_widget_->setStyleSheet("background-color: #2c3e50;");
+    content_widget_->setObjectName("mindMapContent");
     grid_layout_ = new QGridLayout(content_widget_);
     grid_layout_->setContentsMargins(6, 6, 6, 6);
     grid_layout_->setSpacing(4);
-    
-    // Build the horizontal grid
-    build_grid();
-    
-    // Add the "+" button in the next available slot
-    add_button_ = new QPushButton("+");
+
+    add_button_ = new QPushButton("+", content_widget_);
     add_button_->setFixedSize(ui::scaling::scaled(28), ui::scaling::scaled(28));
     add_button_->setCursor(Qt::PointingHandCursor);
     add_button_->setStyleSheet(
@@ -199,10 +247,56 @@ void MindMapView::refresh_layout() {
         "QPushButton:hover { background-color: #2ecc71; }"
     );
     connect(add_button_, &QPushButton::clicked, this, &MindMapView::add_folder_requested);
-    grid_layout_->addWidget(add_button_, next_row_, next_col_);
-    
-    // Set the new content widget
+    add_button_pos_ = {-1, -1};
+
     scroll_area_->setWidget(content_widget_);
+}
+
+void MindMapView::release_content_widget() {
+    if (!content_widget_) return;
+    delete scroll_area_->takeWidget();
+    content_widget_ = nullptr;
+    grid_layout_ = nullptr;
+    add_button_ = nullptr;
+    buttons_.clear();
+    grid_style_.clear();
+    add_button_pos_ = {-1, -1};
+    root_row_span_ = 0;
+}
+
+QSize MindMapView::cell_size() const {
+    // Button dimensions based on display mode
+    int btn_w = custom_width_ > 0 ? ui::scaling::scaled(custom_width_)
+                                   : (compact_mode_ ? ui::scaling::scaled(120) : ui::scaling::scaled(180));
+    int btn_h = compact_mode_ ? ui::scaling::scaled(32) : ui::scaling::scaled(36);
+    return QSize(btn_w, btn_h);
+}
+
+void MindMapView::advance_cell() {
+    // Go down in current column, wrap to next column
+    next_row_++;
+    if (next_row_ >= max_rows_per_col_) {
+        next_row_ = 0;
+        next_col_++;
+    }
+}
+
+void MindMapView::refresh_layout() {
+    if (!model_ || !model_->root_node()) return;
+    refresh_timer_->stop();
+
+    FolderNode* root = model_->root_node();
+    std::vector<FolderNode*> nodes;
+    for (const auto& child : root->children) {
+        collect_grid_nodes(child.get(), nodes);
+    }
+
+    // Hundreds of widgets are slow to create and lay out; paint them instead
+    if (prefer_scene_ || static_cast<int>(nodes.size()) >= kSceneFolderThreshold) {
+        refresh_scene(root, nodes);
+    } else {
+        refresh_widgets(root, nodes);
+    }
 
     // Rebuild keyboard navigation order if in keyboard mode
     if (keyboard_mode_) {
@@ -214,96 +308,158 @@ void MindMapView::refresh_layout() {
     }
 }
 
-void MindMapView::build_grid() {
-    if (!model_ || !model_->root_node()) return;
-    
-    FolderNode* root = model_->root_node();
-    
-    // Button dimensions based on display mode
-    int btn_w = custom_width_ > 0 ? ui::scaling::scaled(custom_width_)
-                                   : (compact_mode_ ? ui::scaling::scaled(120) : ui::scaling::scaled(180));
-    int btn_h = compact_mode_ ? ui::scaling::scaled(32) : ui::scaling::scaled(36);
-    int font_size = compact_mode_ ? 11 : 12;
-    
-    // Root folder in column 0, spanning all rows that children will use
-    auto* root_btn = new FolderButton(root, content_widget_);
-    root_btn->set_show_full_path(show_full_paths_);
-    root_btn->setFixedSize(btn_w, btn_h);
-    root_btn->setStyleSheet(
-        QString("QPushButton { text-align: center; padding: 2px 6px; "
-        "background-color: #1a252f; border: 2px solid #3498db; "
-        "border-radius: 4px; color: #3498db; font-weight: bold; font-size: %1px; }"
-        "QPushButton:hover { background-color: #1e2f3d; }").arg(font_size)
-    );
-    buttons_[root->path] = root_btn;
+void MindMapView::refresh_scene(FolderNode* root, const std::vector<FolderNode*>& nodes) {
+    release_content_widget();
+    if (!scene_view_) {
+        scene_view_ = new MindMapSceneView(this);
+        layout()->addWidget(scene_view_);
+        connect(scene_view_, &MindMapSceneView::folder_clicked, this, &MindMapView::folder_clicked);
+        connect(scene_view_, &MindMapSceneView::folder_context_menu, this, &MindMapView::folder_context_menu);
+        connect(scene_view_, &MindMapSceneView::add_folder_requested, this, &MindMapView::add_folder_requested);
+    }
+    scroll_area_->hide();
+    scene_view_->show();
+    scene_active_ = true;
+
+    grid_positions_.clear();
+    next_row_ = 0;
+    next_col_ = 1;
+    for (FolderNode* node : nodes) {
+        grid_positions_[node->path] = {next_row_, next_col_};
+        advance_cell();
+    }
     grid_positions_[root->path] = {0, 0};
-    
-    connect(root_btn, &FolderButton::folder_clicked, this, &MindMapView::folder_clicked);
-    connect(root_btn, &FolderButton::folder_right_clicked, this, &MindMapView::folder_context_menu);
-    
+    int total_rows = qMax(1, next_row_ + (next_col_ > 1 ? 1 : 0));
+    scene_view_->sync(root, nodes, grid_positions_, total_rows, {next_row_, next_col_},
+                      QSizeF(cell_size()), show_full_paths_, compact_mode_ ? 11 : 12);
+}
+
+void MindMapView::refresh_widgets(FolderNode* root, const std::vector<FolderNode*>& nodes) {
+    if (scene_view_) scene_view_->hide();
+    scroll_area_->show();
+    scene_active_ = false;
+    ensure_content_widget();
+
+    // Display mode only changes the shared sheet and the fixed sizes
+    QString style = folder_grid_style(compact_mode_ ? 11 : 12);
+    if (style != grid_style_) {
+        grid_style_ = style;
+        content_widget_->setStyleSheet(grid_style_);
+    }
+
+    QMap<QString, FolderButton*> previous;
+    previous.swap(buttons_);
+    QMap<QString, QPair<int, int>> old_positions;
+    old_positions.swap(grid_positions_);
+
     // Child folders fill columns 1+ going down, wrapping to next column
     next_row_ = 0;
     next_col_ = 1;
-    
-    for (const auto& child : root->children) {
-        place_folder_node(child.get());
+    for (FolderNode* node : nodes) {
+        bool is_new = !previous.contains(node->path) || previous.value(node->path)->node() != node;
+        FolderButton* btn = take_or_create_button(node, previous);
+        QPair<int, int> cell{next_row_, next_col_};
+        grid_positions_[node->path] = cell;
+        if (is_new || old_positions.value(node->path, {-1, -1}) != cell) {
+            place_button(btn, cell.first, cell.second, is_new);
+        }
+        advance_cell();
     }
-    
-    // Root spans all rows used by children. If next_col_ moved past col 1,
-    // the current next_row_ is partial (items still being placed), so add 1.
+
+    // Root folder in column 0, spanning all rows that children use. If
+    // next_col_ moved past col 1, the current next_row_ is partial, so add 1.
+    bool root_is_new = !previous.contains(root->path) || previous.value(root->path)->node() != root;
+    FolderButton* root_btn = take_or_create_button(root, previous);
+    root_btn->set_root(true);
     int total_rows = qMax(1, next_row_ + (next_col_ > 1 ? 1 : 0));
-    grid_layout_->addWidget(root_btn, 0, 0, total_rows, 1, Qt::AlignVCenter);
+    grid_positions_[root->path] = {0, 0};
+    if (root_is_new || total_rows != root_row_span_) {
+        if (!root_is_new) grid_layout_->removeWidget(root_btn);
+        grid_layout_->addWidget(root_btn, 0, 0, total_rows, 1, Qt::AlignVCenter);
+        root_row_span_ = total_rows;
+    }
+
+    // Whatever is left belongs to folders that are gone
+    for (FolderButton* stale : previous) {
+        grid_layout_->removeWidget(stale);
+        stale->hide();
+        stale->deleteLater();
+    }
+
+    // The "+" button sits in the next available slot
+    QPair<int, int> add_cell{next_row_, next_col_};
+    if (add_cell != add_button_pos_) {
+        if (add_button_pos_.first >= 0) grid_layout_->removeWidget(add_button_);
+        grid_layout_->addWidget(add_button_, add_cell.first, add_cell.second);
+        add_button_pos_ = add_cell;
+    }
 }
 
-void MindMapView::place_folder_node(FolderNode* node) {
-    auto* btn = new FolderButton(node, content_widget_);
-    btn->set_show_full_path(show_full_paths_);
-    
-    // Apply display mode sizing: ensure uniform row height in both modes
-    if (compact_mode_) {
-        int w = custom_width_ > 0 ? ui::scaling::scaled(custom_width_) : ui::scaling::scaled(120);
-        btn->setFixedSize(w, ui::scaling::scaled(32));
+void MindMapView::collect_grid_nodes(FolderNode* node, std::vector<FolderNode*>& out) const {
+    // Depth-first, so subfolders follow their parent in the grid
+    out.push_back(node);
+    for (const auto& child : node->children) {
+        collect_grid_nodes(child.get(), out);
+    }
+}
+
+FolderButton* MindMapView::take_or_create_button(FolderNode* node, QMap<QString, FolderButton*>& previous) {
+    FolderButton* btn = nullptr;
+    auto it = previous.find(node->path);
+    if (it != previous.end() && it.value()->node() == node) {
+        btn = it.value();
+        previous.erase(it);
     } else {
-        int w = custom_width_ > 0 ? ui::scaling::scaled(custom_width_) : ui::scaling::scaled(180);
-        btn->setFixedSize(w, ui::scaling::scaled(36));
+        btn = new FolderButton(node, content_widget_);
+        connect(btn, &FolderButton::folder_clicked, this, &MindMapView::folder_clicked);
+        connect(btn, &FolderButton::folder_right_clicked, this, &MindMapView::folder_context_menu);
     }
-    
+    btn->setFixedSize(cell_size());
+    btn->set_show_full_path(show_full_paths_);
+    btn->refresh_appearance();
     buttons_[node->path] = btn;
-    grid_positions_[node->path] = {next_row_, next_col_};
-    grid_layout_->addWidget(btn, next_row_, next_col_);
-    
-    connect(btn, &FolderButton::folder_clicked, this, &MindMapView::folder_clicked);
-    connect(btn, &FolderButton::folder_right_clicked, this, &MindMapView::folder_context_menu);
-    
-    // Advance: go down in current column, wrap to next column
-    next_row_++;
-    if (next_row_ >= max_rows_per_col_) {
-        next_row_ = 0;
-        next_col_++;
-    }
-    
-    // Place children (they go into the grid too)
-    for (const auto& child : node->children) {
-        place_folder_node(child.get());
+    return btn;
+}
+
+void MindMapView::place_button(FolderButton* btn, int row, int col, bool is_new) {
+    if (!is_new) grid_layout_->removeWidget(btn);
+    grid_layout_->addWidget(btn, row, col);
+    btn->show();
+}
+
+void MindMapView::update_folder_counts(const QStringList& folder_paths) {
+    // A pending relayout re-labels everything anyway
+    if (!model_ || refresh_timer_->isActive()) return;
+    int width = cell_size().width();
+    for (const QString& path : folder_paths) {
+        if (scene_active_) {
+            if (FolderNode* node = model_->find_node(path)) {
+                scene_view_->update_label(path, FolderButton::label_for(node, show_full_paths_, width));
+            }
+        } else if (FolderButton* btn = buttons_.value(path)) {
+            btn->update_display();
+        }
     }
 }
 
 void MindMapView::zoom_in() {
-    // No-op for widget-based view
+    // The widget grid has fixed-size buttons; only the painted map zooms
+    if (scene_active_) scene_view_->zoom_by(1.25);
 }
 
 void MindMapView::zoom_out() {
-    // No-op for widget-based view
+    if (scene_active_) scene_view_->zoom_by(0.8);
 }
 
 void MindMapView::zoom_fit() {
-    // No-op for widget-based view
+    if (scene_active_) scene_view_->zoom_fit();
 }
 
 void MindMapView::set_selected_folder(const QString& path) {
     for (auto it = buttons_.begin(); it != buttons_.end(); ++it) {
         it.value()->set_selected(it.key() == path);
     }
+    if (scene_active_) scene_view_->set_selected_path(path);
 }
 
 void MindMapView::dragEnterEvent(QDragEnterEvent* event) {
@@ -374,6 +530,7 @@ void MindMapView::set_keyboard_mode(bool on) {
         for (auto it = buttons_.begin(); it != buttons_.end(); ++it) {
             it.value()->set_selected(false);
         }
+        if (scene_active_) scene_view_->set_selected_path(QString());
     }
 }
 
@@ -406,6 +563,13 @@ void MindMapView::update_focus_visual() {
         it.value()->set_selected(false);
     }
 
+    if (scene_active_) {
+        QString path = focused_folder_path();
+        scene_view_->set_selected_path(path);
+        if (!path.isEmpty()) scene_view_->ensure_path_visible(path);
+        return;
+    }
+
     if (focused_index_ >= 0 && focused_index_ < ordered_paths_.size()) {
         QString path = ordered_paths_[focused_index_];
         if (buttons_.contains(path)) {
@@ -0,0 +1,222 @@
+#include "MockAiProvider.hpp"
+#include "AiRequestDispatcher.hpp"
+#include "AppLogger.hpp"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QFile>
+#include <QTimer>
+#include <QPointer>
+#include <algorithm>
+
+MockAiOptions MockAiOptions::from_settings() {
+    QSettings settings("FileTinder", "FileTinder");
+    MockAiOptions options;
+    options.latency_ms = settings.value("mockAi/latencyMs", options.latency_ms).toInt();
+    options.jitter_ms = settings.value("mockAi/jitterMs", options.jitter_ms).toInt();
+    options.rate_limit_every = settings.value("mockAi/rateLimitEvery", options.rate_limit_every).toInt();
+    options.retry_after_secs = settings.value("mockAi/retryAfterSecs", options.retry_after_secs).toInt();
+    options.malformed_every = settings.value("mockAi/malformedEvery", options.malformed_every).toInt();
+    options.replay_path = settings.value("mockAi/replayPath").toString();
+    options.seed = settings.value("mockAi/seed", options.seed).toUInt();
+    return options;
+}
+
+MockAiProvider& MockAiProvider::instance() {
+    static MockAiProvider provider_instance;
+    return provider_instance;
+}
+
+MockAiProvider::MockAiProvider()
+    : rng_(options_.seed) {}
+
+void MockAiProvider::set_options(const MockAiOptions& options) {
+    options_ = options;
+    rng_.seed(options_.seed);
+    requests_served_ = 0;
+    load_replay();
+}
+
+QString MockAiProvider::ensure_started() {
+    if (!server_) {
+        server_ = new QTcpServer(this);
+        connect(server_, &QTcpServer::newConnection, this, &MockAiProvider::on_new_connection);
+    }
+    if (!server_->isListening() && !server_->listen(QHostAddress::LocalHost, 0)) {
+        LOG_ERROR("MockAI", QString("Could not listen: %1").arg(server_->errorString()));
+        return QString();
+    }
+    return QString("http://127.0.0.1:%1").arg(server_->serverPort());
+}
+
+void MockAiProvider::load_replay() {
+    replay_.clear();
+    if (options_.replay_path.isEmpty()) return;
+    QFile file(options_.replay_path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        LOG_WARN("MockAI", QString("Replay file not readable: %1").arg(options_.replay_path));
+        return;
+    }
+    while (!file.atEnd()) {
+        QJsonObject entry = QJsonDocument::fromJson(file.readLine()).object();
+        QByteArray key = entry["key"].toString().toLatin1();
+        if (!key.isEmpty()) replay_.insert(key, entry["content"].toString());
+    }
+    LOG_INFO("MockAI", QString("Loaded %1 recorded responses").arg(replay_.size()));
+}
+
+void MockAiProvider::on_new_connection() {
+    while (QTcpSocket* socket = server_->nextPendingConnection()) {
+        connections_.insert(socket, Connection());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { on_ready_read(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            connections_.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MockAiProvider::on_ready_read(QTcpSocket* socket) {
+    auto it = connections_.find(socket);
+    if (it == connections_.end() || it->handled) return;
+    it->buffer += socket->readAll();
+
+    int header_end = it->buffer.indexOf("\r\n\r\n");
+    if (header_end < 0) return;
+    QByteArray head = it->buffer.left(header_end);
+    qsizetype content_length = 0;
+    for (const QByteArray& line : head.split('\n')) {
+        if (line.toLower().startsWith("content-length:")) content_length = line.mid(15).trimmed().toLongLong();
+    }
+    QByteArray body = it->buffer.mid(header_end + 4);
+    if (body.size() < content_length) return;
+
+    it->handled = true;
+    QByteArray path = head.left(head.indexOf('\r')).split(' ').value(1);
+    handle_request(socket, path, body.left(content_length));
+}
+
+void MockAiProvider::handle_request(QTcpSocket* socket, const QByteArray& path, const QByteArray& body) {
+    int request_number = ++requests_served_;
+    QJsonObject request = QJsonDocument::fromJson(body).object();
+    bool anthropic = path.endsWith("/messages");
+    bool stream = request["stream"].toBool();
+
+    // Reassemble the prompt the way the dispatcher split it
+    QString prompt;
+    if (anthropic) {
+        for (const QJsonValue& block : request["system"].toArray()) prompt += block.toObject()["text"].toString();
+    }
+    for (const QJsonValue& message : request["messages"].toArray()) {
+        if (message.toObject()["role"].toString() == "user") prompt += message.toObject()["content"].toString();
+    }
+
+    int delay = options_.latency_ms + (options_.jitter_ms > 0 ? static_cast<int>(rng_.bounded(options_.jitter_ms + 1)) : 0);
+    bool rate_limited = options_.rate_limit_every > 0 && request_number % options_.rate_limit_every == 0;
+    bool malformed = options_.malformed_every > 0 && request_number % options_.malformed_every == 0;
+
+    QString content;
+    if (!rate_limited) {
+        auto replayed = replay_.constFind(AiRequestDispatcher::prompt_key(prompt));
+        content = replayed != replay_.constEnd() ? replayed.value() : synthesize_answer(prompt);
+        if (malformed) {
+            // What parse recovery has to cope with: chatter plus a cut-off array
+            content = "Sure! Here is the classification:\n```json\n" + content.left(content.size() * 3 / 5);
+        }
+    }
+    LOG_DEBUG("MockAI", QString("Request %1 %2: %3 ms%4%5").arg(request_number).arg(QString::fromLatin1(path))
+        .arg(delay).arg(rate_limited ? ", 429" : "").arg(malformed ? ", malformed" : ""));
+
+    QPointer<QTcpSocket> guard(socket);
+    QTimer::singleShot(delay, this, [this, guard, anthropic, stream, rate_limited, content]() {
+        if (!guard) return;
+        if (rate_limited) {
+            write_http(guard, 429, "application/json",
+                       R"({"error":{"type":"rate_limit_error","message":"Mock rate limit"}})",
+                       "Retry-After: " + QByteArray::number(options_.retry_after_secs) + "\r\n");
+            return;
+        }
+        send_response(guard, anthropic, stream, content);
+    });
+}
+
+void MockAiProvider::send_response(QTcpSocket* socket, bool anthropic, bool stream, const QString& content) {
+    if (!stream) {
+        QJsonObject reply;
+        if (anthropic) {
+            reply["type"] = "message";
+            reply["content"] = QJsonArray{QJsonObject{{"type", "text"}, {"text", content}}};
+        } else {
+            QJsonObject message{{"role", "assistant"}, {"content", content}};
+            reply["choices"] = QJsonArray{QJsonObject{{"index", 0}, {"message", message}}};
+        }
+        write_http(socket, 200, "application/json", QJsonDocument(reply).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    // Server-sent events, in small deltas like a real model
+    QByteArray events;
+    constexpr int kChunkChars = 24;
+    for (qsizetype pos = 0; pos < content.size(); pos += kChunkChars) {
+        QString piece = content.mid(pos, kChunkChars);
+        QJsonObject event;
+        if (anthropic) {
+            event["type"] = "content_block_delta";
+            event["delta"] = QJsonObject{{"type", "text_delta"}, {"text", piece}};
+            events += "event: content_block_delta\n";
+        } else {
+            QJsonObject delta{{"content", piece}};
+            event["choices"] = QJsonArray{QJsonObject{{"index", 0}, {"delta", delta}}};
+        }
+        events += "data: " + QJsonDocument(event).toJson(QJsonDocument::Compact) + "\n\n";
+    }
+    events += anthropic ? QByteArray("event: message_stop\ndata: {\"type\":\"message_stop\"}\n\n")
+                        : QByteArray("data: [DONE]\n\n");
+    write_http(socket, 200, "text/event-stream", events);
+}
+
+void MockAiProvider::write_http(QTcpSocket* socket, int status, const QByteArray& content_type,
+                                const QByteArray& body, const QByteArray& extra_headers) {
+    QByteArray reason = status == 200 ? "OK" : (status == 429 ? "Too Many Requests" : "Error");
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " " + reason + "\r\n"
+                          "Content-Type: " + content_type + "\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n" + extra_headers + "\r\n" + body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QString MockAiProvider::synthesize_answer(const QString& prompt) {
+    static const QRegularExpression folder_line("^F(\\d+) = ", QRegularExpression::MultilineOption);
+    // index|name|size|type[|content hint]
+    static const QRegularExpression file_line("^(\\d+)\\|[^|]*\\|[^|]*\\|([a-z])(?:\\|.*)?$",
+                                              QRegularExpression::MultilineOption);
+
+    int folder_count = 0;
+    auto folders = folder_line.globalMatch(prompt);
+    while (folders.hasNext()) folder_count = std::max(folder_count, folders.next().captured(1).toInt() + 1);
+
+    // Stable answers: the folder depends only on the type code
+    QJsonArray answer;
+    auto files = file_line.globalMatch(prompt);
+    while (files.hasNext()) {
+        auto match = files.next();
+        int index = match.captured(1).toInt();
+        QChar code = match.captured(2).at(0);
+        QString folder = folder_count > 0
+            ? QString("F%1").arg(code.unicode() % folder_count)
+            : QString("Mock/%1").arg(code.toUpper());
+        QJsonObject obj;
+        obj["i"] = index;
+        obj["f"] = QJsonArray{folder};
+        obj["c"] = QJsonArray{60 + (index * 37) % 40};
+        obj["r"] = QString("mock: type %1").arg(code);
+        answer.append(obj);
+    }
+    return QString::fromUtf8(QJsonDocument(answer).toJson(QJsonDocument::Compact));
+}
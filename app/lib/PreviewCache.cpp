@@ -0,0 +1,56 @@
+#include "PreviewCache.hpp"
+#include <QFileInfo>
+#include <QDateTime>
+#include <algorithm>
+
+PreviewCache& PreviewCache::instance() {
+    static PreviewCache cache_instance;
+    return cache_instance;
+}
+
+PreviewCache::PreviewCache() {
+    images_.setMaxCost(kImageBudgetKb);
+    texts_.setMaxCost(kTextBudgetChars);
+}
+
+QString PreviewCache::make_key(const QString& file_path, const QString& kind) {
+    QFileInfo info(file_path);
+    return QString("%1|%2|%3|%4")
+        .arg(kind, info.absoluteFilePath())
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+bool PreviewCache::get_image(const QString& key, QImage& out) const {
+    QMutexLocker locker(&mutex_);
+    const QImage* cached = images_.object(key);
+    if (!cached) return false;
+    out = *cached;
+    return true;
+}
+
+void PreviewCache::put_image(const QString& key, const QImage& image) {
+    if (image.isNull()) return;
+    QMutexLocker locker(&mutex_);
+    int cost = std::max(1, static_cast<int>(image.sizeInBytes() / 1024));
+    images_.insert(key, new QImage(image), cost);
+}
+
+bool PreviewCache::get_text(const QString& key, QString& out) const {
+    QMutexLocker locker(&mutex_);
+    const QString* cached = texts_.object(key);
+    if (!cached) return false;
+    out = *cached;
+    return true;
+}
+
+void PreviewCache::put_text(const QString& key, const QString& text) {
+    QMutexLocker locker(&mutex_);
+    texts_.insert(key, new QString(text), std::max(1, static_cast<int>(text.size())));
+}
+
+void PreviewCache::clear() {
+    QMutexLocker locker(&mutex_);
+    images_.clear();
+    texts_.clear();
+}
@@ -0,0 +1,222 @@
+#include "RulesDialog.hpp"
+#include "StandaloneFileTinderDialog.hpp"
+#include "ui_constants.hpp"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QComboBox>
+#include <QMessageBox>
+#include <algorithm>
+
+RulesDialog::RulesDialog(const std::vector<FileToProcess>& files, const FileQuery::Columns& columns,
+                         const FileSearchIndex* index, QWidget* parent)
+    : QDialog(parent)
+    , files_(files)
+    , columns_(columns)
+    , index_(index)
+{
+    setWindowTitle("Auto-Decision Rules");
+    build_ui();
+    for (const DecisionRule& rule : DecisionRuleEngine::load_rules()) add_row(rule);
+    if (table_->rowCount() == 0) add_row(DecisionRule());
+    invalidate_preview();
+}
+
+void RulesDialog::build_ui() {
+    setMinimumSize(ui::scaling::scaled(720), ui::scaling::scaled(380));
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(12, 12, 12, 12);
+    layout->setSpacing(8);
+
+    auto* header = new QLabel("Rules run top to bottom; each pending file takes the first rule it matches.");
+    header->setStyleSheet("font-size: 13px; font-weight: bold; color: #ecf0f1;");
+    layout->addWidget(header);
+
+    auto* hint = new QLabel("Queries use the filter syntax, e.g. \"type:video size>2GB age>2y\" or "
+                            "\"name:IMG_* is:duplicate\". Move destinations may be relative to the source folder.");
+    hint->setStyleSheet("color: #888; font-size: 10px;");
+    hint->setWordWrap(true);
+    layout->addWidget(hint);
+
+    table_ = new QTableWidget(0, 5);
+    table_->setHorizontalHeaderLabels({"On", "Query", "Action", "Destination", "Matches"});
+    table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table_->setSelectionMode(QAbstractItemView::SingleSelection);
+    table_->verticalHeader()->setVisible(false);
+    table_->horizontalHeader()->setSectionResizeMode(QueryColumn, QHeaderView::Stretch);
+    table_->horizontalHeader()->setSectionResizeMode(DestinationColumn, QHeaderView::Stretch);
+    table_->setStyleSheet(
+        "QTableWidget { background-color: #1e1e1e; border: 1px solid #404040; color: #ecf0f1; }"
+        "QTableWidget::item:selected { background-color: #0078d4; }");
+    connect(table_, &QTableWidget::itemChanged, this, [this]() { invalidate_preview(); });
+    layout->addWidget(table_, 1);
+
+    status_label_ = new QLabel();
+    status_label_->setStyleSheet("color: #888; font-size: 11px;");
+    status_label_->setWordWrap(true);
+    layout->addWidget(status_label_);
+
+    auto* btn_row = new QHBoxLayout();
+    const QString plain_style =
+        "QPushButton { padding: 6px 14px; background-color: #4a4a4a; color: #ccc; border: 1px solid #555; border-radius: 3px; }"
+        "QPushButton:hover { background-color: #555; }";
+
+    auto* add_btn = new QPushButton("Add");
+    add_btn->setStyleSheet(plain_style);
+    connect(add_btn, &QPushButton::clicked, this, [this]() {
+        add_row(DecisionRule());
+        table_->selectRow(table_->rowCount() - 1);
+        invalidate_preview();
+    });
+    btn_row->addWidget(add_btn);
+
+    auto* remove_btn = new QPushButton("Remove");
+    remove_btn->setStyleSheet(plain_style);
+    connect(remove_btn, &QPushButton::clicked, this, [this]() {
+        int row = table_->currentRow();
+        if (row < 0) return;
+        table_->removeRow(row);
+        invalidate_preview();
+    });
+    btn_row->addWidget(remove_btn);
+
+    auto* up_btn = new QPushButton("Up");
+    up_btn->setStyleSheet(plain_style);
+    connect(up_btn, &QPushButton::clicked, this, [this]() { move_selected_row(-1); });
+    btn_row->addWidget(up_btn);
+
+    auto* down_btn = new QPushButton("Down");
+    down_btn->setStyleSheet(plain_style);
+    connect(down_btn, &QPushButton::clicked, this, [this]() { move_selected_row(1); });
+    btn_row->addWidget(down_btn);
+
+    btn_row->addStretch();
+
+    auto* preview_btn = new QPushButton("Preview");
+    preview_btn->setStyleSheet(
+        "QPushButton { padding: 6px 14px; background-color: #2980b9; color: white; border: none; border-radius: 3px; }"
+        "QPushButton:hover { background-color: #3498db; }");
+    connect(preview_btn, &QPushButton::clicked, this, &RulesDialog::on_preview);
+    btn_row->addWidget(preview_btn);
+
+    apply_btn_ = new QPushButton("Apply");
+    apply_btn_->setStyleSheet(
+        "QPushButton { padding: 6px 14px; background-color: #27ae60; color: white; border: none; border-radius: 3px; }"
+        "QPushButton:hover { background-color: #2ecc71; }"
+        "QPushButton:disabled { background-color: #555; color: #888; }");
+    connect(apply_btn_, &QPushButton::clicked, this, &RulesDialog::on_apply);
+    btn_row->addWidget(apply_btn_);
+
+    auto* close_btn = new QPushButton("Close");
+    close_btn->setStyleSheet(plain_style);
+    connect(close_btn, &QPushButton::clicked, this, &QDialog::reject);
+    btn_row->addWidget(close_btn);
+
+    layout->addLayout(btn_row);
+}
+
+void RulesDialog::add_row(const DecisionRule& rule) {
+    QSignalBlocker blocker(table_);
+    int row = table_->rowCount();
+    table_->insertRow(row);
+
+    auto* enabled = new QTableWidgetItem();
+    enabled->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    enabled->setCheckState(rule.enabled ? Qt::Checked : Qt::Unchecked);
+    table_->setItem(row, EnabledColumn, enabled);
+    table_->setItem(row, QueryColumn, new QTableWidgetItem(rule.query));
+
+    auto* action = new QComboBox();
+    action->addItem("Keep", "keep");
+    action->addItem("Delete", "delete");
+    action->addItem("Move to...", "move");
+    action->setCurrentIndex(std::max(0, action->findData(rule.action)));
+    connect(action, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() { invalidate_preview(); });
+    table_->setCellWidget(row, ActionColumn, action);
+
+    table_->setItem(row, DestinationColumn, new QTableWidgetItem(rule.destination));
+    auto* matches = new QTableWidgetItem();
+    matches->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    matches->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    table_->setItem(row, MatchesColumn, matches);
+}
+
+std::vector<DecisionRule> RulesDialog::rules_from_table() const {
+    std::vector<DecisionRule> rules;
+    for (int row = 0; row < table_->rowCount(); ++row) {
+        DecisionRule rule;
+        rule.enabled = table_->item(row, EnabledColumn)->checkState() == Qt::Checked;
+        rule.query = table_->item(row, QueryColumn)->text().trimmed();
+        rule.action = static_cast<QComboBox*>(table_->cellWidget(row, ActionColumn))->currentData().toString();
+        rule.destination = table_->item(row, DestinationColumn)->text().trimmed();
+        rules.push_back(rule);
+    }
+    return rules;
+}
+
+void RulesDialog::move_selected_row(int delta) {
+    int row = table_->currentRow();
+    int target = row + delta;
+    if (row < 0 || target < 0 || target >= table_->rowCount()) return;
+
+    // Cell widgets can't be moved between rows; rebuild from the rule list
+    std::vector<DecisionRule> rules = rules_from_table();
+    std::swap(rules[row], rules[target]);
+    table_->setRowCount(0);
+    for (const DecisionRule& rule : rules) add_row(rule);
+    table_->selectRow(target);
+    invalidate_preview();
+}
+
+void RulesDialog::invalidate_preview() {
+    result_ = RuleMatchResult();
+    apply_btn_->setEnabled(false);
+    QSignalBlocker blocker(table_);
+    for (int row = 0; row < table_->rowCount(); ++row) {
+        if (auto* item = table_->item(row, MatchesColumn)) item->setText(QString());
+    }
+    status_label_->setStyleSheet("color: #888; font-size: 11px;");
+    status_label_->setText("Preview to see how many files each rule would decide.");
+}
+
+void RulesDialog::on_preview() {
+    std::vector<DecisionRule> rules = rules_from_table();
+    DecisionRuleEngine::save_rules(rules);
+
+    QString error;
+    if (!engine_.set_rules(rules, &error)) {
+        invalidate_preview();
+        status_label_->setStyleSheet("color: #e74c3c; font-size: 11px;");
+        status_label_->setText(error);
+        return;
+    }
+    result_ = engine_.match(files_, columns_, index_);
+
+    QSignalBlocker blocker(table_);
+    int keep = 0, del = 0, move = 0;
+    for (size_t r = 0; r < rules.size(); ++r) {
+        int count = result_.per_rule[r];
+        table_->item(static_cast<int>(r), MatchesColumn)->setText(rules[r].enabled ? QString::number(count) : "off");
+        if (rules[r].action == "keep") keep += count;
+        else if (rules[r].action == "delete") del += count;
+        else move += count;
+    }
+    int pending = 0;
+    for (const auto& file : files_) {
+        if (file.decision == "pending") ++pending;
+    }
+    status_label_->setStyleSheet("color: #bdc3c7; font-size: 11px;");
+    status_label_->setText(QString("%1 of %2 pending files would be decided: %3 keep, %4 delete, %5 move (%6 ms)")
+        .arg(result_.matched).arg(pending).arg(keep).arg(del).arg(move).arg(result_.elapsed_ms));
+    apply_btn_->setEnabled(result_.matched > 0);
+}
+
+void RulesDialog::on_apply() {
+    if (result_.matched == 0) return;
+    auto reply = QMessageBox::question(this, "Apply Rules",
+        QString("Decide %1 files now?\n\nPress Z afterwards to undo the whole pass.").arg(result_.matched),
+        QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+    if (reply == QMessageBox::Yes) accept();
+}
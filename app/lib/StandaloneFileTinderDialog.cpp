@@ -4,7 +4,14 @@
 #include "AppLogger.hpp"
 #include "ImagePreviewWindow.hpp"
 #include "FileListWindow.hpp"
+#include "RulesDialog.hpp"
 #include "DuplicateDetectionWindow.hpp"
+#include "PreviewCache.hpp"
+#include "VideoThumbnailer.hpp"
+#include "TextPreviewLoader.hpp"
+#include "DirectorySummarizer.hpp"
+#include "DocumentThumbnailer.hpp"
+#include "ArchiveInspector.hpp"
 #include "ui_constants.hpp"
 #include <QDir>
 #include <QFileInfo>
@@ -16,7 +23,6 @@
 #include <QResizeEvent>
 #include <QPixmap>
 #include <QMimeDatabase>
-#include <QTextStream>
 #include <QScrollArea>
 #include <QGroupBox>
 #include <QProgressDialog>
@@ -36,8 +42,11 @@
 #include <QUrl>
 #include <QMouseEvent>
 #include <QElapsedTimer>
+#include <QLocale>
 #include <QMenu>
 #include <QImageReader>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 #include <algorithm>
 
 StandaloneFileTinderDialog::StandaloneFileTinderDialog(const QString& source_folder,
@@ -80,7 +89,11 @@ StandaloneFileTinderDialog::StandaloneFileTinderDialog(const QString& source_fol
     , resize_timer_(nullptr)
     , file_position_label_(nullptr)
     , size_badge_label_(nullptr)
-    , search_box_(nullptr) {
+    , search_box_(nullptr)
+    , preview_generation_(std::make_shared<std::atomic<int>>(0)) {
+    
+    // Keep preview decoding off the global pool so it never starves other work
+    preview_pool_.setMaxThreadCount(2);
     
     setWindowTitle(QString("File Tinder - Basic Mode — %1").arg(QFileInfo(source_folder).fileName()));
     
@@ -99,7 +112,12 @@ StandaloneFileTinderDialog::StandaloneFileTinderDialog(const QString& source_fol
     // with derived classes. Call initialize() after construction instead.
 }
 
-StandaloneFileTinderDialog::~StandaloneFileTinderDialog() = default;
+StandaloneFileTinderDialog::~StandaloneFileTinderDialog() {
+    // Drop queued previews; the pool's destructor waits for running ones,
+    // and bumping the generation kills any document render helper
+    preview_pool_.clear();
+    preview_generation_->fetch_add(1);
+}
 
 void StandaloneFileTinderDialog::initialize() {
     setup_ui();
@@ -250,6 +268,29 @@ void StandaloneFileTinderDialog::setup_ui() {
             this, &StandaloneFileTinderDialog::on_folders_toggle_changed);
     filter_layout->addWidget(folders_checkbox_);
     
+    // Query, e.g. "type:video size>2GB age>2y"
+    query_edit_ = new QLineEdit();
+    query_edit_->setPlaceholderText("Query: type:video size>2GB age>2y");
+    const QString query_help = "Fields: size, age, modified, type, ext, name, decision, is:duplicate.\n"
+                               "Terms are ANDed; use 'or', '-' and parentheses to combine. Enter to apply.";
+    const QString query_style = "QLineEdit { padding: 4px 8px; background-color: #34495e; "
+                                "border: 1px solid %1; border-radius: 4px; color: white; }";
+    query_edit_->setToolTip(query_help);
+    query_edit_->setMinimumWidth(ui::scaling::scaled(220));
+    query_edit_->setStyleSheet(query_style.arg("#4a6078"));
+    auto apply_query = [this, query_help, query_style]() {
+        QString error;
+        bool ok = set_filter_query(query_edit_->text(), &error);
+        // Red border and the parse error as tooltip until the query compiles
+        query_edit_->setStyleSheet(query_style.arg(ok ? "#4a6078" : "#e74c3c"));
+        query_edit_->setToolTip(ok ? query_help : error);
+    };
+    connect(query_edit_, &QLineEdit::returnPressed, this, apply_query);
+    connect(query_edit_, &QLineEdit::textChanged, this, [this, apply_query](const QString& text) {
+        if (text.isEmpty() && !filter_query_.is_empty()) apply_query();
+    });
+    filter_layout->addWidget(query_edit_);
+    
     filter_layout->addSpacing(20);
     
     // Sort
@@ -490,34 +531,30 @@ void StandaloneFileTinderDialog::setup_ui() {
     );
     file_list_btn->setToolTip("Open file list window (multi-select, drag to folders)");
     connect(file_list_btn, &QPushButton::clicked, this, [this]() {
-        auto* flw = new FileListWindow(files_, filtered_indices_, current_filtered_index_, this);
+        auto* flw = new FileListWindow(files_, filtered_indices_, current_filtered_index_, &search_index_, this);
         connect(flw, &FileListWindow::file_selected, this, [this](int filtered_idx) {
             if (filtered_idx >= 0 && filtered_idx < static_cast<int>(filtered_indices_.size())) {
                 current_filtered_index_ = filtered_idx;
                 show_current_file();
             }
         });
-        connect(flw, &FileListWindow::files_assigned, this, [this](const QList<int>& indices, const QString& dest) {
-            for (int fi : indices) {
-                if (fi >= 0 && fi < static_cast<int>(files_.size())) {
-                    auto& file = files_[fi];
-                    QString old_decision = file.decision;
-                    file.decision = "move";
-                    file.destination_folder = dest;
-                    update_decision_count(old_decision, -1);
-                    move_count_++;
-                    record_action(fi, old_decision, "move", dest);
-                }
-            }
-            update_progress();
-            update_stats();
-            show_current_file();
-        });
+        connect(flw, &FileListWindow::files_assigned, this, &StandaloneFileTinderDialog::assign_files_to_folder);
         flw->set_destination_folders(get_destination_folders());
         flw->show();
     });
     bottom_layout->addWidget(file_list_btn);
     
+    auto* rules_btn = new QPushButton("Rules");
+    rules_btn->setFixedHeight(ui::scaling::scaled(36));
+    rules_btn->setStyleSheet(
+        "QPushButton { font-size: 11px; padding: 6px 12px; "
+        "background-color: #34495e; border-radius: 4px; color: white; border: 1px solid #4a6078; }"
+        "QPushButton:hover { background-color: #3d566e; }"
+    );
+    rules_btn->setToolTip("Decide many files at once with ordered query rules");
+    connect(rules_btn, &QPushButton::clicked, this, &StandaloneFileTinderDialog::show_rules_dialog);
+    bottom_layout->addWidget(rules_btn);
+    
     bottom_layout->addSpacing(10);
     
     finish_btn_ = new QPushButton("Finish Review");
@@ -543,6 +580,8 @@ void StandaloneFileTinderDialog::setup_ui() {
 
 void StandaloneFileTinderDialog::scan_files() {
     files_.clear();
+    search_index_.clear();
+    query_columns_.clear();
     QMimeDatabase mime_db;
     
     QDir dir(source_folder_);
@@ -656,11 +695,13 @@ void StandaloneFileTinderDialog::load_session_state() {
 }
 
 void StandaloneFileTinderDialog::save_session_state() {
+    std::vector<FileDecision> decisions;
     for (const auto& file : files_) {
         if (file.decision != "pending") {
-            db_.save_file_decision(source_folder_, file.path, file.decision, file.destination_folder);
+            decisions.push_back({file.path, file.decision, file.destination_folder, 0});
         }
     }
+    db_.save_file_decisions(source_folder_, decisions);
 }
 
 void StandaloneFileTinderDialog::show_current_file() {
@@ -702,6 +743,9 @@ void StandaloneFileTinderDialog::show_current_file() {
 void StandaloneFileTinderDialog::update_preview(const QString& file_path) {
     if (!preview_label_) return;
     
+    // Invalidate any preview still being generated for the previous file
+    preview_generation_->fetch_add(1);
+    
     QFileInfo finfo(file_path);
     QMimeDatabase mime_db;
     QMimeType mime_type = mime_db.mimeTypeForFile(file_path);
@@ -713,6 +757,7 @@ void StandaloneFileTinderDialog::update_preview(const QString& file_path) {
     // Reset style and alignment from any previous text file preview
     preview_label_->setStyleSheet("");
     preview_label_->setAlignment(Qt::AlignCenter);
+    preview_label_->setTextFormat(Qt::AutoText);
     
     // Determine icon for the file type (always shown centered)
     QString icon = "[FILE]";
@@ -761,29 +806,132 @@ void StandaloneFileTinderDialog::update_preview(const QString& file_path) {
         }
     }
     
-    // For text files, show content preview
-    if (type.startsWith("text/") && !finfo.isDir()) {
-        QFile file(file_path);
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream stream(&file);
-            QString content = stream.read(1500);  // Reduced to avoid overflow
-            if (!stream.atEnd()) {
-                content += "\n...(truncated)";
+    // For videos, show a filmstrip of keyframes decoded on the preview pool
+    if (type.startsWith("video/") && !finfo.isDir() && VideoThumbnailer::is_available()) {
+        QString key = PreviewCache::make_key(file_path, "video");
+        QImage strip;
+        if (PreviewCache::instance().get_image(key, strip)) {
+            show_preview_image(strip);
+            return;
+        }
+        preview_label_->setText("Extracting frames...");
+        QString comment = mime_type.comment();
+        // Stops between frames once the user moves on or the dialog closes
+        auto generation_token = preview_generation_;
+        int generation = generation_token->load();
+        run_preview_job([file_path, key, generation_token, generation]() -> QVariant {
+            auto cancelled = [generation_token, generation]() { return generation != generation_token->load(); };
+            QImage strip = VideoThumbnailer::extract_filmstrip(
+                file_path, ui::dimensions::kFilmstripFrames,
+                ui::scaling::scaled(ui::dimensions::kFilmstripFrameHeight), cancelled);
+            if (!cancelled()) PreviewCache::instance().put_image(key, strip);
+            return strip;
+        }, [this, comment](const QVariant& result) {
+            QImage strip = result.value<QImage>();
+            if (strip.isNull()) {
+                preview_label_->setText(QString("File Type: %1\n\nNo preview available").arg(comment));
+                return;
             }
+            show_preview_image(strip);
+        });
+        return;
+    }
+    
+    // For PDFs and office documents, show the first page / embedded thumbnail
+    if (!finfo.isDir() && DocumentThumbnailer::can_render(file_path, type)) {
+        QString key = PreviewCache::make_key(file_path, "document");
+        QImage page;
+        if (PreviewCache::instance().get_image(key, page)) {
+            show_preview_image(page);
+            return;
+        }
+        preview_label_->setText("Rendering preview...");
+        QSize max_size(ui::scaling::scaled(ui::dimensions::kPreviewMaxWidth),
+                       ui::scaling::scaled(ui::dimensions::kPreviewMaxHeight));
+        QString comment = mime_type.comment();
+        // Rendered in a helper process: a malformed document that hangs the
+        // renderer is killed at the timeout, or as soon as the user moves on,
+        // instead of holding a preview thread
+        auto generation_token = preview_generation_;
+        int generation = generation_token->load();
+        run_preview_job([file_path, type, key, max_size, generation_token, generation]() -> QVariant {
+            auto cancelled = [generation_token, generation]() { return generation != generation_token->load(); };
+            QImage page = DocumentThumbnailer::render_isolated(file_path, type, max_size,
+                                                               kDocumentPreviewTimeoutMs, cancelled);
+            if (!cancelled()) PreviewCache::instance().put_image(key, page);
+            return page;
+        }, [this, comment](const QVariant& result) {
+            QImage page = result.value<QImage>();
+            if (page.isNull()) {
+                preview_label_->setText(QString("File Type: %1\n\nNo preview available").arg(comment));
+                return;
+            }
+            show_preview_image(page);
+        });
+        return;
+    }
+    
+    // For zip/tar archives, list contents from the directory/headers only
+    if (!finfo.isDir() && ArchiveInspector::can_inspect(file_path)) {
+        QString key = PreviewCache::make_key(file_path, "archive");
+        QString listing;
+        // Entry names are untrusted; never let them render as rich text
+        preview_label_->setTextFormat(Qt::PlainText);
+        if (PreviewCache::instance().get_text(key, listing)) {
+            preview_label_->setText(listing);
+            return;
+        }
+        preview_label_->setText("Reading archive...");
+        run_preview_job([file_path, key]() -> QVariant {
+            QString listing = ArchiveInspector::format_for_display(ArchiveInspector::inspect(file_path));
+            PreviewCache::instance().put_text(key, listing);
+            return listing;
+        }, [this](const QVariant& result) {
+            preview_label_->setTextFormat(Qt::PlainText);
+            preview_label_->setText(result.toString());
+        });
+        return;
+    }
+    
+    // For text files, show a bounded head (+ tail) excerpt loaded on the preview pool
+    if (type.startsWith("text/") && !finfo.isDir()) {
+        auto show_text = [this](const QString& content) {
+            preview_label_->setTextFormat(Qt::PlainText);
             preview_label_->setText(content);
             preview_label_->setAlignment(Qt::AlignTop | Qt::AlignLeft);
             preview_label_->setStyleSheet("color: #ecf0f1; font-family: monospace; font-size: 11px;");
+        };
+        QString key = PreviewCache::make_key(file_path, "text");
+        QString content;
+        if (PreviewCache::instance().get_text(key, content)) {
+            show_text(content);
             return;
         }
+        preview_label_->setText("Loading preview...");
+        run_preview_job([file_path, key]() -> QVariant {
+            QString content = TextPreviewLoader::format_for_display(TextPreviewLoader::load(file_path));
+            PreviewCache::instance().put_text(key, content);
+            return content;
+        }, [show_text](const QVariant& result) {
+            show_text(result.toString());
+        });
+        return;
     }
     
-    // For directories
+    // For directories, summarize the tree on the preview pool
     if (finfo.isDir()) {
-        QDir dir(file_path);
-        int file_count = dir.entryList(QDir::Files | QDir::NoDotAndDotDot).count();
-        int dir_count = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot).count();
-        preview_label_->setText(QString("Directory contains:\n%1 files\n%2 subdirectories")
-                               .arg(file_count).arg(dir_count));
+        QString key = PreviewCache::make_key(file_path, "dir");
+        QString summary;
+        if (PreviewCache::instance().get_text(key, summary)) {
+            preview_label_->setText(summary);
+            return;
+        }
+        preview_label_->setText("Directory\n\nScanning contents...");
+        run_preview_job([file_path]() -> QVariant {
+            return summarize_directory_cached(file_path, false);
+        }, [this](const QVariant& result) {
+            preview_label_->setText(result.toString());
+        });
         return;
     }
     
@@ -791,6 +939,46 @@ void StandaloneFileTinderDialog::update_preview(const QString& file_path) {
     preview_label_->setText(QString("File Type: %1\n\nNo preview available").arg(mime_type.comment()));
 }
 
+void StandaloneFileTinderDialog::run_preview_job(std::function<QVariant()> job,
+                                                 std::function<void(const QVariant&)> on_ready) {
+    auto generation_token = preview_generation_;
+    int generation = generation_token->load();
+    
+    auto* watcher = new QFutureWatcher<QVariant>(this);
+    connect(watcher, &QFutureWatcher<QVariant>::finished, this, [this, watcher, generation, on_ready]() {
+        watcher->deleteLater();
+        // User already swiped to another file
+        if (generation != preview_generation_->load()) return;
+        on_ready(watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&preview_pool_, [generation_token, generation, job]() -> QVariant {
+        // Skip jobs that went stale while queued
+        if (generation != generation_token->load()) return QVariant();
+        return job();
+    }));
+}
+
+QString StandaloneFileTinderDialog::summarize_directory_cached(const QString& dir_path, bool brief) {
+    // One walk fills both cache entries (card text and the one-line form)
+    DirectorySummary summary = DirectorySummarizer::summarize(dir_path);
+    QString full = DirectorySummarizer::format_for_display(summary);
+    QString short_form = DirectorySummarizer::format_brief(summary);
+    PreviewCache::instance().put_text(PreviewCache::make_key(dir_path, "dir"), full);
+    PreviewCache::instance().put_text(PreviewCache::make_key(dir_path, "dir-brief"), short_form);
+    return brief ? short_form : full;
+}
+
+void StandaloneFileTinderDialog::show_preview_image(const QImage& image) {
+    if (!preview_label_ || image.isNull()) return;
+    int max_w = preview_label_->width() > 100 ? preview_label_->width() - 20 : 400;
+    int max_h = preview_label_->height() > 100 ? preview_label_->height() - 20 : 300;
+    QImage fitted = image;
+    if (image.width() > max_w || image.height() > max_h) {
+        fitted = image.scaled(max_w, max_h, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    preview_label_->setPixmap(QPixmap::fromImage(fitted));
+}
+
 void StandaloneFileTinderDialog::update_file_info(const FileToProcess& file) {
     QString size_str;
     if (file.is_directory) {
@@ -873,6 +1061,70 @@ void StandaloneFileTinderDialog::update_stats() {
     stats_label_->setText(stats);
 }
 
+void StandaloneFileTinderDialog::assign_files_to_folder(const QList<int>& indices, const QString& dest) {
+    for (int fi : indices) {
+        if (fi >= 0 && fi < static_cast<int>(files_.size())) {
+            auto& file = files_[fi];
+            QString old_decision = file.decision;
+            file.decision = "move";
+            file.destination_folder = dest;
+            update_decision_count(old_decision, -1);
+            move_count_++;
+            record_action(fi, old_decision, "move", dest);
+        }
+    }
+    update_progress();
+    update_stats();
+    show_current_file();
+}
+
+void StandaloneFileTinderDialog::show_rules_dialog() {
+    RulesDialog dialog(files_, query_columns_, &search_index_, this);
+    if (dialog.exec() != QDialog::Accepted) return;
+    
+    const auto& rules = dialog.engine().rules();
+    const RuleMatchResult& result = dialog.result();
+    if (result.rule_for_file.size() != files_.size()) return;
+    
+    std::vector<FileDecision> decisions;
+    decisions.reserve(result.matched);
+    QHash<QString, int> moves_per_folder;
+    ActionRecord record;
+    record.file_index = -1;
+    record.previous_decision = "pending";
+    record.new_decision = "rules";
+    record.batch.reserve(result.matched);
+    QDir source_dir(source_folder_);
+    for (size_t fi = 0; fi < files_.size(); ++fi) {
+        int r = result.rule_for_file[fi];
+        if (r < 0) continue;
+        auto& file = files_[fi];
+        if (file.decision != "pending") continue;
+        const DecisionRule& rule = rules[r];
+        record.batch.emplace_back(static_cast<int>(fi), file.destination_folder);
+        file.decision = rule.action;
+        if (rule.action == "move") {
+            // Relative destinations are under the source folder
+            file.destination_folder = QDir::cleanPath(source_dir.absoluteFilePath(rule.destination));
+            moves_per_folder[file.destination_folder]++;
+        }
+        update_decision_count(rule.action, 1);
+        decisions.push_back({file.path, file.decision, file.destination_folder, 0});
+    }
+    
+    if (decisions.empty()) return;
+    
+    // Recorded in one transaction, and undone as one step with Z
+    db_.save_file_decisions(source_folder_, decisions);
+    on_bulk_moves(moves_per_folder);
+    undo_stack_.push_back(std::move(record));
+    if (undo_btn_) undo_btn_->setEnabled(true);
+    LOG_INFO("BasicMode", QString("Rules decided %1 files in %2 ms").arg(decisions.size()).arg(result.elapsed_ms));
+    
+    reposition_after_filter(-1);
+    update_stats();
+}
+
 // Helper to update decision counts (deduplication of count logic)
 void StandaloneFileTinderDialog::update_decision_count(const QString& old_decision, int delta) {
     if (old_decision == "keep") keep_count_ += delta;
@@ -1034,6 +1286,14 @@ void StandaloneFileTinderDialog::on_undo() {
         ActionRecord last_action = undo_stack_.back();
         undo_stack_.pop_back();
         
+        if (!last_action.batch.empty()) {
+            undo_batch(last_action);
+            if (undo_stack_.empty() && undo_btn_) {
+                undo_btn_->setEnabled(false);
+            }
+            return;
+        }
+        
         // Revert the file's decision
         auto& file = files_[last_action.file_index];
         LOG_INFO("BasicMode", QString("Undoing action on file: %1 (was %2, reverting to %3)")
@@ -1079,6 +1339,28 @@ void StandaloneFileTinderDialog::on_undo() {
     }
 }
 
+void StandaloneFileTinderDialog::undo_batch(const ActionRecord& action) {
+    std::vector<FileDecision> decisions;
+    decisions.reserve(action.batch.size());
+    QHash<QString, int> moves_per_folder;
+    for (const auto& [fi, previous_dest] : action.batch) {
+        if (fi < 0 || fi >= static_cast<int>(files_.size())) continue;
+        auto& file = files_[fi];
+        update_decision_count(file.decision, -1);
+        if (file.decision == "move") moves_per_folder[file.destination_folder]--;
+        file.decision = action.previous_decision;
+        file.destination_folder = previous_dest;
+        decisions.push_back({file.path, file.decision, file.destination_folder, 0});
+    }
+    LOG_INFO("BasicMode", QString("Undoing rules pass on %1 files").arg(decisions.size()));
+    
+    db_.save_file_decisions(source_folder_, decisions);
+    on_bulk_moves(moves_per_folder);
+    
+    reposition_after_filter(-1);
+    update_stats();
+}
+
 void StandaloneFileTinderDialog::on_show_preview() {
     try {
         // Toggle inline preview visibility in basic mode
@@ -1514,7 +1796,6 @@ void StandaloneFileTinderDialog::execute_decisions() {
     // Collect unique destination folders from move decisions
     QSet<QString> dest_folders;
     
-    std::vector<std::pair<QString, QString>> files_to_copy;
     for (const auto& file : files_) {
         if (file.decision == "delete") {
             plan.files_to_delete.push_back(file.path);
@@ -1522,7 +1803,7 @@ void StandaloneFileTinderDialog::execute_decisions() {
             plan.files_to_move.push_back({file.path, file.destination_folder});
             dest_folders.insert(file.destination_folder);
         } else if (file.decision == "copy" && !file.destination_folder.isEmpty()) {
-            files_to_copy.push_back({file.path, file.destination_folder});
+            plan.files_to_copy.push_back({file.path, file.destination_folder});
             dest_folders.insert(file.destination_folder);
         }
     }
@@ -1534,11 +1815,23 @@ void StandaloneFileTinderDialog::execute_decisions() {
         }
     }
     
+    // Dry run before anything is touched: name collisions, missing sources,
+    // permissions and free space are reported up front
+    FileTinderExecutor executor;
+    DryRunReport dry_run = executor.simulate(plan);
+    LOG_INFO("Execute", QString("Dry run: %1 problems, %2 renamed, %3 to copy, ~%4 ms")
+        .arg(dry_run.problems.size()).arg(dry_run.renamed)
+        .arg(QLocale().formattedDataSize(dry_run.bytes_to_copy)).arg(dry_run.estimated_ms));
+    if (dry_run.has_problems() || !dry_run.warnings.isEmpty()) {
+        if (!show_dry_run_report(dry_run)) return;
+    }
+    plan = dry_run.resolved_plan;
+    
     // Requirement 20: Verify we can create virtual folders before proceeding
     QSet<QString> failed_folders;
     for (const QString& folder : plan.folders_to_create) {
         if (!QDir().mkpath(folder)) {
-            failed_folders.insert(folder);
+            failed_folders.insert(QDir::cleanPath(folder));
             auto reply = QMessageBox::warning(this, "Folder Creation Failed",
                 QString("Could not create folder:\n%1\n\n"
                         "Files assigned to this folder will be skipped.\n"
@@ -1550,22 +1843,18 @@ void StandaloneFileTinderDialog::execute_decisions() {
     // Clear the create list since we handled it above
     plan.folders_to_create.clear();
     
-    // Execute copy operations
-    for (const auto& [src, dest_folder] : files_to_copy) {
-        if (failed_folders.contains(dest_folder)) continue;
-        QString dest_path = QDir::cleanPath(dest_folder + "/" + QFileInfo(src).fileName());
-        if (!QFile::copy(src, dest_path)) {
-            LOG_WARN("Execute", QString("Failed to copy: %1 -> %2 (error: %3)")
-                .arg(src, dest_path, QFile(src).errorString()));
-        }
-    }
-    
-    // Remove moves targeting failed folders
+    // Remove moves and copies targeting failed folders; resolved destinations
+    // are file paths, so compare their folder
     if (!failed_folders.isEmpty()) {
+        auto targets_failed = [&](const auto& pair) {
+            return failed_folders.contains(QFileInfo(pair.second).absolutePath());
+        };
         plan.files_to_move.erase(
-            std::remove_if(plan.files_to_move.begin(), plan.files_to_move.end(),
-                [&](const auto& pair) { return failed_folders.contains(pair.second); }),
+            std::remove_if(plan.files_to_move.begin(), plan.files_to_move.end(), targets_failed),
             plan.files_to_move.end());
+        plan.files_to_copy.erase(
+            std::remove_if(plan.files_to_copy.begin(), plan.files_to_copy.end(), targets_failed),
+            plan.files_to_copy.end());
     }
     
     // Progress dialog
@@ -1576,7 +1865,6 @@ void StandaloneFileTinderDialog::execute_decisions() {
     QElapsedTimer timer;
     timer.start();
     
-    FileTinderExecutor executor;
     auto result = executor.execute(plan, [&](int current, int total, const QString& msg) {
         if (total > 0) {
             progress.setValue(current * 100 / total);
@@ -1605,6 +1893,63 @@ void StandaloneFileTinderDialog::execute_decisions() {
     accept();
 }
 
+bool StandaloneFileTinderDialog::show_dry_run_report(const DryRunReport& report) {
+    QDialog dialog(this);
+    dialog.setWindowTitle("Before Executing");
+    dialog.setMinimumSize(ui::scaling::scaled(640), ui::scaling::scaled(420));
+    
+    auto* layout = new QVBoxLayout(&dialog);
+    QLocale locale;
+    
+    const ExecutionPlan& plan = report.resolved_plan;
+    QString summary = QString("%1 move(s), %2 copy(ies), %3 delete(s), %4 new folder(s)\n"
+                              "Data to copy: %5 | Estimated time: ~%6s")
+        .arg(plan.files_to_move.size()).arg(plan.files_to_copy.size())
+        .arg(plan.files_to_delete.size()).arg(plan.folders_to_create.size())
+        .arg(locale.formattedDataSize(report.bytes_to_copy))
+        .arg(qMax<qint64>(1, (report.estimated_ms + 999) / 1000));
+    for (const DeviceEstimate& device : report.devices) {
+        if (device.bytes_to_write == 0) continue;
+        summary += QString("\n  • %1: %2 in %3 file(s), %4 free").arg(device.root)
+            .arg(locale.formattedDataSize(device.bytes_to_write)).arg(device.files)
+            .arg(device.bytes_available >= 0 ? locale.formattedDataSize(device.bytes_available) : "unknown");
+    }
+    auto* summary_label = new QLabel(summary);
+    summary_label->setStyleSheet("font-size: 12px; padding: 8px;");
+    layout->addWidget(summary_label);
+    
+    auto add_list = [&](const QString& title, const QStringList& lines, const QString& color) {
+        if (lines.isEmpty()) return;
+        auto* title_label = new QLabel(QString("%1 (%2):").arg(title).arg(lines.size()));
+        title_label->setStyleSheet(QString("font-weight: bold; color: %1; margin-top: 6px;").arg(color));
+        layout->addWidget(title_label);
+        auto* list = new QListWidget();
+        list->addItems(lines);
+        list->setStyleSheet(QString("QListWidget { color: %1; font-size: 11px; }").arg(color));
+        layout->addWidget(list, 1);
+    };
+    add_list("Problems — these operations will fail", report.problems, "#e74c3c");
+    add_list("Warnings", report.warnings, "#f39c12");
+    
+    auto* btn_layout = new QHBoxLayout();
+    auto* cancel_btn = new QPushButton("Cancel");
+    connect(cancel_btn, &QPushButton::clicked, &dialog, &QDialog::reject);
+    btn_layout->addWidget(cancel_btn);
+    btn_layout->addStretch();
+    
+    auto* execute_btn = new QPushButton(report.has_problems() ? "Execute the Rest" : "Execute");
+    execute_btn->setStyleSheet(
+        "QPushButton { background-color: #2ecc71; color: white; font-weight: bold; "
+        "padding: 10px 20px; border-radius: 6px; }"
+        "QPushButton:hover { background-color: #27ae60; }"
+    );
+    connect(execute_btn, &QPushButton::clicked, &dialog, &QDialog::accept);
+    btn_layout->addWidget(execute_btn);
+    layout->addLayout(btn_layout);
+    
+    return dialog.exec() == QDialog::Accepted;
+}
+
 void StandaloneFileTinderDialog::show_execution_results(const ExecutionResult& result, qint64 elapsed_ms) {
     QDialog results_dialog(this);
     results_dialog.setWindowTitle("Execution Complete");
@@ -1630,11 +1975,11 @@ void StandaloneFileTinderDialog::show_execution_results(const ExecutionResult& r
         "  • Skipped: %5\n"
         "  • Moved: %6\n\n"
         "Execution time: %7s\n"
-        "Files moved: %8 | Files deleted: %9 | Errors: %10"
+        "Files moved: %8 | Files copied: %9 | Files deleted: %10 | Errors: %11"
     ).arg(total_files).arg(total_reviewed)
      .arg(keep_count_).arg(delete_count_).arg(skip_count_).arg(move_count_)
      .arg(elapsed_sec, 0, 'f', 1)
-     .arg(result.files_moved).arg(result.files_deleted).arg(result.errors));
+     .arg(result.files_moved).arg(result.files_copied).arg(result.files_deleted).arg(result.errors));
     stats_text->setStyleSheet("font-size: 12px; padding: 8px;");
     stats_layout->addWidget(stats_text);
     
@@ -1793,29 +2138,14 @@ void StandaloneFileTinderDialog::keyPressEvent(QKeyEvent* event) {
             } else {
                 // F opens File List window (same as clicking "File List" button)
                 {
-                    auto* flw = new FileListWindow(files_, filtered_indices_, current_filtered_index_, this);
+                    auto* flw = new FileListWindow(files_, filtered_indices_, current_filtered_index_, &search_index_, this);
                     connect(flw, &FileListWindow::file_selected, this, [this](int filtered_idx) {
                         if (filtered_idx >= 0 && filtered_idx < static_cast<int>(filtered_indices_.size())) {
                             current_filtered_index_ = filtered_idx;
                             show_current_file();
                         }
                     });
-                    connect(flw, &FileListWindow::files_assigned, this, [this](const QList<int>& indices, const QString& dest) {
-                        for (int fi : indices) {
-                            if (fi >= 0 && fi < static_cast<int>(files_.size())) {
-                                auto& file = files_[fi];
-                                QString old_decision = file.decision;
-                                file.decision = "move";
-                                file.destination_folder = dest;
-                                update_decision_count(old_decision, -1);
-                                move_count_++;
-                                record_action(fi, old_decision, "move", dest);
-                            }
-                        }
-                        update_progress();
-                        update_stats();
-                        show_current_file();
-                    });
+                    connect(flw, &FileListWindow::files_assigned, this, &StandaloneFileTinderDialog::assign_files_to_folder);
                     flw->set_destination_folders(get_destination_folders());
                     flw->show();
                 }
@@ -2002,6 +2332,13 @@ void StandaloneFileTinderDialog::apply_sort() {
     };
     
     std::sort(files_.begin(), files_.end(), compare_fn);
+    rebuild_search_index();
+}
+
+void StandaloneFileTinderDialog::rebuild_search_index() {
+    // The index and query columns are keyed by position in files_
+    search_index_.build(files_);
+    query_columns_.build(files_);
 }
 
 void StandaloneFileTinderDialog::show_custom_extension_dialog() {
@@ -2071,10 +2408,30 @@ void StandaloneFileTinderDialog::apply_filter(FileFilterType filter) {
         }
     }
     
+    int prev_file_idx = get_current_file_index();
     rebuild_filtered_indices();
+    reposition_after_filter(prev_file_idx);
+}
+
+bool StandaloneFileTinderDialog::set_filter_query(const QString& text, QString* error) {
+    FileQuery query = FileQuery::compile(text);
+    if (!query.is_valid()) {
+        if (error) *error = query.error();
+        return false;
+    }
+    filter_query_ = query;
     
-    // Stay on current file if it matches the new filter, otherwise find first pending
     int prev_file_idx = get_current_file_index();
+    rebuild_filtered_indices();
+    LOG_INFO("BasicMode", QString("Query '%1' matches %2 of %3 files")
+        .arg(filter_query_.text()).arg(filtered_indices_.size()).arg(files_.size()));
+    reposition_after_filter(prev_file_idx);
+    update_stats();
+    return true;
+}
+
+void StandaloneFileTinderDialog::reposition_after_filter(int prev_file_idx) {
+    // Stay on current file if it matches the new filter, otherwise find first pending
     bool found_current = false;
     if (prev_file_idx >= 0) {
         for (size_t i = 0; i < filtered_indices_.size(); ++i) {
@@ -2111,7 +2468,13 @@ void StandaloneFileTinderDialog::apply_filter(FileFilterType filter) {
 void StandaloneFileTinderDialog::rebuild_filtered_indices() {
     filtered_indices_.clear();
     
+    // The query is evaluated for all files at once, then combined per file
+    std::vector<quint8> query_hits;
+    bool use_query = !filter_query_.is_empty();
+    if (use_query) query_hits = filter_query_.evaluate(files_, query_columns_, &search_index_);
+    
     for (size_t i = 0; i < files_.size(); ++i) {
+        if (use_query && !query_hits[i]) continue;
         if (file_matches_filter(files_[i])) {
             filtered_indices_.push_back(static_cast<int>(i));
         }
@@ -2294,12 +2657,14 @@ void StandaloneFileTinderDialog::on_search(const QString& text) {
     int count = static_cast<int>(filtered_indices_.size());
     if (count == 0) return;
     
+    std::vector<bool> hits = search_index_.match_mask(text);
+    if (hits.size() != files_.size()) return;
+    
     // Search forward from the position after the current one, wrapping around
     int start = (current_filtered_index_ + 1) % count;
     for (int offset = 0; offset < count; ++offset) {
         int i = (start + offset) % count;
-        const auto& file = files_[filtered_indices_[i]];
-        if (file.name.contains(text, Qt::CaseInsensitive)) {
+        if (hits[filtered_indices_[i]]) {
             current_filtered_index_ = i;
             show_current_file();
             return;
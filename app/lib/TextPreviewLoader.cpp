@@ -0,0 +1,136 @@
+#include "TextPreviewLoader.hpp"
+#include <QFile>
+#include <QStringDecoder>
+#include <algorithm>
+
+TextPreview TextPreviewLoader::load(const QString& file_path) {
+    TextPreview preview;
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) return preview;
+
+    preview.file_size = file.size();
+    QByteArray head = read_window(file, 0, std::min(preview.file_size, kHeadBytes));
+
+    int bom_length = 0;
+    preview.encoding = detect_encoding(head, bom_length);
+    preview.is_binary = looks_binary(head, preview.encoding);
+    if (preview.is_binary) return preview;
+
+    QString head_text = decode(head.mid(bom_length), preview.encoding);
+    if (head_text.size() > kHeadChars || preview.file_size > kHeadBytes) {
+        preview.truncated = true;
+        head_text.truncate(kHeadChars);
+    }
+    preview.text = head_text;
+
+    // Large files: also show the end (where logs keep the interesting part)
+    if (preview.file_size > kHeadBytes + kTailBytes) {
+        QByteArray tail = read_window(file, preview.file_size - kTailBytes, kTailBytes);
+        if (preview.encoding == "UTF-8") {
+            // Don't start mid code point
+            int skip = 0;
+            while (skip < tail.size() && (static_cast<unsigned char>(tail[skip]) & 0xC0) == 0x80) ++skip;
+            tail.remove(0, skip);
+        } else if (preview.encoding.startsWith("UTF-16") && (tail.size() % 2) != 0) {
+            tail.remove(0, 1);
+        }
+        QString tail_text = decode(tail, preview.encoding);
+        // Start the tail on a line boundary when there is one nearby
+        int newline = tail_text.indexOf('\n');
+        if (newline >= 0 && newline < tail_text.size() - 1) tail_text = tail_text.mid(newline + 1);
+        if (tail_text.size() > kTailChars) tail_text = tail_text.right(kTailChars);
+
+        // Everything between the shown head and the shown tail
+        qint64 shown_bytes = bom_length + encoded_size(head_text, preview.encoding) +
+                             encoded_size(tail_text, preview.encoding);
+        qint64 omitted_kb = std::max<qint64>(0, preview.file_size - shown_bytes) / 1024;
+        preview.text += QString("\n\n...(%1 KB omitted)...\n\n").arg(omitted_kb) + tail_text;
+        preview.has_tail = true;
+    }
+    return preview;
+}
+
+QString TextPreviewLoader::format_for_display(const TextPreview& preview) {
+    if (preview.is_binary) {
+        return QString("Binary content (%1 bytes)\n\nNo text preview available").arg(preview.file_size);
+    }
+    if (preview.truncated && !preview.has_tail) {
+        return preview.text + "\n...(truncated)";
+    }
+    return preview.text;
+}
+
+QByteArray TextPreviewLoader::read_window(QFile& file, qint64 offset, qint64 length) {
+    if (length <= 0) return QByteArray();
+    // Map only the requested window; fall back to a bounded read on
+    // file systems that don't support mmap
+    if (uchar* mapped = file.map(offset, length)) {
+        QByteArray bytes(reinterpret_cast<const char*>(mapped), static_cast<int>(length));
+        file.unmap(mapped);
+        return bytes;
+    }
+    if (!file.seek(offset)) return QByteArray();
+    return file.read(length);
+}
+
+QString TextPreviewLoader::detect_encoding(const QByteArray& head, int& bom_length) {
+    bom_length = 0;
+    if (head.startsWith("\xEF\xBB\xBF")) {
+        bom_length = 3;
+        return "UTF-8";
+    }
+    if (head.startsWith("\xFF\xFE")) {
+        bom_length = 2;
+        return "UTF-16LE";
+    }
+    if (head.startsWith("\xFE\xFF")) {
+        bom_length = 2;
+        return "UTF-16BE";
+    }
+
+    // No BOM: guess UTF-16 from alternating NULs in ASCII-heavy text
+    int sample = std::min<int>(head.size(), 512) & ~1;
+    int even_nuls = 0, odd_nuls = 0;
+    for (int i = 0; i < sample; i += 2) {
+        if (head[i] == '\0') ++even_nuls;
+        if (head[i + 1] == '\0') ++odd_nuls;
+    }
+    if (sample >= 8) {
+        if (odd_nuls > sample * 2 / 5 && even_nuls == 0) return "UTF-16LE";
+        if (even_nuls > sample * 2 / 5 && odd_nuls == 0) return "UTF-16BE";
+    }
+
+    // Stateful decoder keeps a trailing partial sequence instead of
+    // flagging it, so a window cut mid character still validates
+    QStringDecoder utf8(QStringDecoder::Utf8);
+    QString decoded = utf8.decode(head);
+    Q_UNUSED(decoded);
+    return utf8.hasError() ? "Latin-1" : "UTF-8";
+}
+
+bool TextPreviewLoader::looks_binary(const QByteArray& head, const QString& encoding) {
+    if (head.isEmpty() || encoding.startsWith("UTF-16")) return false;
+    int control = 0;
+    for (char c : head) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (byte == 0) return true;
+        if (byte < 0x20 && byte != '\n' && byte != '\r' && byte != '\t' && byte != '\f' && byte != 0x1B) {
+            ++control;
+        }
+    }
+    return control * 10 > head.size();
+}
+
+qint64 TextPreviewLoader::encoded_size(const QString& text, const QString& encoding) {
+    if (encoding == "Latin-1") return text.size();
+    if (encoding.startsWith("UTF-16")) return text.size() * 2;
+    return text.toUtf8().size();
+}
+
+QString TextPreviewLoader::decode(const QByteArray& bytes, const QString& encoding) {
+    if (encoding == "Latin-1") return QString::fromLatin1(bytes);
+    QStringDecoder decoder(encoding == "UTF-16LE" ? QStringDecoder::Utf16LE
+                           : encoding == "UTF-16BE" ? QStringDecoder::Utf16BE
+                           : QStringDecoder::Utf8);
+    return decoder.decode(bytes);
+}
@@ -0,0 +1,169 @@
+#include "VideoThumbnailer.hpp"
+#include "AppLogger.hpp"
+#include <QPainter>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QFileInfo>
+#include <QElapsedTimer>
+
+#ifdef FILETINDER_HAS_QT_MULTIMEDIA
+#include <QMediaPlayer>
+#include <QVideoSink>
+#include <QVideoFrame>
+#include <QEventLoop>
+#include <QTimer>
+#include <QUrl>
+#endif
+
+QImage VideoThumbnailer::extract_filmstrip(const QString& file_path, int frame_count, int frame_height,
+                                           const std::function<bool()>& cancelled) {
+    if (frame_count <= 0 || frame_height <= 0 || !QFileInfo(file_path).isFile()) return QImage();
+
+    QList<QImage> frames = grab_frames_multimedia(file_path, frame_count, frame_height, cancelled);
+    if (frames.isEmpty() && !(cancelled && cancelled())) {
+        frames = grab_frames_ffmpeg(file_path, frame_count, frame_height, cancelled);
+    }
+    if (cancelled && cancelled()) return QImage();
+    if (frames.isEmpty()) {
+        LOG_DEBUG("Preview", QString("No video frames extracted from %1").arg(file_path));
+        return QImage();
+    }
+    return compose_filmstrip(frames, frame_height);
+}
+
+bool VideoThumbnailer::is_available() {
+#ifdef FILETINDER_HAS_QT_MULTIMEDIA
+    return true;
+#else
+    // grab_frames_ffmpeg needs ffprobe for the duration as well
+    return !QStandardPaths::findExecutable("ffmpeg").isEmpty() &&
+           !QStandardPaths::findExecutable("ffprobe").isEmpty();
+#endif
+}
+
+QList<QImage> VideoThumbnailer::grab_frames_multimedia(const QString& file_path, int frame_count, int frame_height,
+                                                       const std::function<bool()>& cancelled) {
+    QList<QImage> frames;
+#ifdef FILETINDER_HAS_QT_MULTIMEDIA
+    // Player and sink live on this worker thread; a local event loop
+    // drives them so nothing touches the GUI thread.
+    QMediaPlayer player;
+    QVideoSink sink;
+    player.setVideoSink(&sink);
+
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    QObject::connect(&player, &QMediaPlayer::errorOccurred, &loop, &QEventLoop::quit);
+    QObject::connect(&player, &QMediaPlayer::mediaStatusChanged, &loop,
+                     [&loop](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::InvalidMedia) {
+            loop.quit();
+        }
+    });
+
+    player.setSource(QUrl::fromLocalFile(file_path));
+    if (player.mediaStatus() != QMediaPlayer::LoadedMedia) {
+        timeout.start(kLoadTimeoutMs);
+        loop.exec();
+    }
+    if (player.error() != QMediaPlayer::NoError || !player.hasVideo() || player.duration() <= 0) {
+        return frames;
+    }
+
+    QImage latest;
+    QObject::connect(&sink, &QVideoSink::videoFrameChanged, &loop,
+                     [&loop, &latest](const QVideoFrame& frame) {
+        if (!frame.isValid()) return;
+        latest = frame.toImage();
+        loop.quit();
+    });
+
+    // Pausing from the stopped state presents the first frame; discard it
+    // so the seeks below each wait for their own frame.
+    player.pause();
+    timeout.start(kFrameTimeoutMs);
+    loop.exec();
+
+    qint64 duration = player.duration();
+    for (int i = 0; i < frame_count; ++i) {
+        if (cancelled && cancelled()) break;
+        latest = QImage();
+        player.setPosition(duration * (i + 1) / (frame_count + 1));
+        timeout.start(kFrameTimeoutMs);
+        loop.exec();
+        if (!latest.isNull()) {
+            frames.append(latest.scaledToHeight(frame_height, Qt::SmoothTransformation));
+        }
+    }
+    player.stop();
+#else
+    Q_UNUSED(file_path);
+    Q_UNUSED(frame_count);
+    Q_UNUSED(frame_height);
+    Q_UNUSED(cancelled);
+#endif
+    return frames;
+}
+
+bool VideoThumbnailer::wait_for(QProcess& process, int timeout_ms, const std::function<bool()>& cancelled) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!process.waitForFinished(kProcessPollMs)) {
+        if (process.state() == QProcess::NotRunning) break;
+        if (timer.elapsed() >= timeout_ms || (cancelled && cancelled())) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+    }
+    return process.exitStatus() == QProcess::NormalExit;
+}
+
+QList<QImage> VideoThumbnailer::grab_frames_ffmpeg(const QString& file_path, int frame_count, int frame_height,
+                                                   const std::function<bool()>& cancelled) {
+    QList<QImage> frames;
+    QString ffmpeg = QStandardPaths::findExecutable("ffmpeg");
+    QString ffprobe = QStandardPaths::findExecutable("ffprobe");
+    if (ffmpeg.isEmpty() || ffprobe.isEmpty()) return frames;
+
+    QProcess probe;
+    probe.start(ffprobe, {"-v", "error", "-show_entries", "format=duration",
+                          "-of", "default=noprint_wrappers=1:nokey=1", file_path});
+    if (!wait_for(probe, kLoadTimeoutMs, cancelled)) return frames;
+    bool ok = false;
+    double duration = QString::fromUtf8(probe.readAllStandardOutput()).trimmed().toDouble(&ok);
+    if (!ok || duration <= 0.0) return frames;
+
+    for (int i = 0; i < frame_count; ++i) {
+        if (cancelled && cancelled()) break;
+        double seconds = duration * (i + 1) / (frame_count + 1);
+        QProcess grab;
+        grab.start(ffmpeg, {"-v", "error", "-ss", QString::number(seconds, 'f', 2), "-i", file_path,
+                            "-frames:v", "1", "-vf", QString("scale=-2:%1").arg(frame_height),
+                            "-f", "image2pipe", "-vcodec", "png", "-"});
+        if (!wait_for(grab, kFrameTimeoutMs, cancelled)) continue;
+        QImage frame = QImage::fromData(grab.readAllStandardOutput(), "PNG");
+        if (!frame.isNull()) frames.append(frame);
+    }
+    return frames;
+}
+
+QImage VideoThumbnailer::compose_filmstrip(const QList<QImage>& frames, int frame_height) {
+    int total_width = 0;
+    for (const QImage& frame : frames) total_width += frame.width();
+    total_width += kFrameSpacing * (static_cast<int>(frames.size()) - 1);
+
+    QImage strip(total_width, frame_height, QImage::Format_ARGB32_Premultiplied);
+    strip.fill(Qt::transparent);
+
+    QPainter painter(&strip);
+    int x = 0;
+    for (const QImage& frame : frames) {
+        painter.drawImage(x, (frame_height - frame.height()) / 2, frame);
+        x += frame.width() + kFrameSpacing;
+    }
+    painter.end();
+    return strip;
+}
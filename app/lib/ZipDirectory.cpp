@@ -0,0 +1,203 @@
+#include "ZipDirectory.hpp"
+#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+
+#ifdef FILETINDER_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+    constexpr quint32 kEocdSignature = 0x06054b50;
+    constexpr quint32 kZip64LocatorSignature = 0x07064b50;
+    constexpr quint32 kZip64EocdSignature = 0x06064b50;
+    constexpr quint32 kCentralHeaderSignature = 0x02014b50;
+    constexpr quint32 kLocalHeaderSignature = 0x04034b50;
+    constexpr int kEocdSize = 22;
+    constexpr int kCentralHeaderSize = 46;
+    constexpr int kLocalHeaderSize = 30;
+
+    quint16 read16(const char* p) { return qFromLittleEndian<quint16>(p); }
+    quint32 read32(const char* p) { return qFromLittleEndian<quint32>(p); }
+    quint64 read64(const char* p) { return qFromLittleEndian<quint64>(p); }
+}
+
+bool ZipDirectory::open(const QString& file_path) {
+    path_ = file_path;
+    entries_.clear();
+    declared_entries_ = 0;
+    truncated_ = false;
+
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    quint64 cd_offset = 0, cd_size = 0;
+    if (!read_eocd(file, cd_offset, cd_size)) return false;
+    if (cd_offset + cd_size > static_cast<quint64>(file.size())) return false;
+
+    // Directory can be large for huge archives; read at most kMaxDirectoryBytes
+    qint64 to_read = static_cast<qint64>(std::min<quint64>(cd_size, kMaxDirectoryBytes));
+    if (!file.seek(static_cast<qint64>(cd_offset))) return false;
+    QByteArray cd = file.read(to_read);
+    if (cd.size() != to_read) return false;
+    truncated_ = (static_cast<quint64>(to_read) < cd_size);
+
+    const char* data = cd.constData();
+    qint64 pos = 0;
+    while (pos + kCentralHeaderSize <= cd.size()) {
+        const char* h = data + pos;
+        if (read32(h) != kCentralHeaderSignature) break;
+
+        quint16 flags = read16(h + 8);
+        quint16 name_len = read16(h + 28);
+        quint16 extra_len = read16(h + 30);
+        quint16 comment_len = read16(h + 32);
+        if (pos + kCentralHeaderSize + name_len + extra_len > cd.size()) {
+            truncated_ = true;
+            break;
+        }
+
+        ZipEntry entry;
+        entry.method = read16(h + 10);
+        entry.compressed_size = read32(h + 20);
+        entry.uncompressed_size = read32(h + 24);
+        entry.local_header_offset = read32(h + 42);
+        QByteArray raw_name(h + kCentralHeaderSize, name_len);
+        // Bit 11: name is UTF-8, otherwise CP437 (Latin-1 is close enough for display)
+        entry.name = (flags & 0x0800) ? QString::fromUtf8(raw_name) : QString::fromLatin1(raw_name);
+        entry.is_directory = entry.name.endsWith('/');
+
+        // Zip64 extended sizes live in extra field 0x0001, present only
+        // for the fields that overflowed 32 bits, in this order
+        const char* extra = h + kCentralHeaderSize + name_len;
+        for (int e = 0; e + 4 <= extra_len;) {
+            quint16 id = read16(extra + e);
+            quint16 len = read16(extra + e + 2);
+            if (e + 4 + len > extra_len) break;
+            if (id == 0x0001) {
+                const char* z = extra + e + 4;
+                int zpos = 0;
+                if (entry.uncompressed_size == 0xFFFFFFFF && zpos + 8 <= len) {
+                    entry.uncompressed_size = read64(z + zpos);
+                    zpos += 8;
+                }
+                if (entry.compressed_size == 0xFFFFFFFF && zpos + 8 <= len) {
+                    entry.compressed_size = read64(z + zpos);
+                    zpos += 8;
+                }
+                if (entry.local_header_offset == 0xFFFFFFFF && zpos + 8 <= len) {
+                    entry.local_header_offset = read64(z + zpos);
+                }
+            }
+            e += 4 + len;
+        }
+
+        entries_.push_back(entry);
+        pos += kCentralHeaderSize + name_len + extra_len + comment_len;
+        if (static_cast<int>(entries_.size()) >= kMaxEntries) {
+            truncated_ = true;
+            break;
+        }
+    }
+    return true;
+}
+
+bool ZipDirectory::read_eocd(QFile& file, quint64& cd_offset, quint64& cd_size) {
+    qint64 file_size = file.size();
+    if (file_size < kEocdSize) return false;
+
+    // EOCD sits at the end, followed by a comment of at most 64 KB
+    qint64 tail_len = std::min<qint64>(file_size, kEocdSize + 0xFFFF);
+    if (!file.seek(file_size - tail_len)) return false;
+    QByteArray tail = file.read(tail_len);
+    if (tail.size() != tail_len) return false;
+
+    qint64 eocd = -1;
+    for (qint64 i = tail.size() - kEocdSize; i >= 0; --i) {
+        if (read32(tail.constData() + i) == kEocdSignature) {
+            eocd = i;
+            break;
+        }
+    }
+    if (eocd < 0) return false;
+
+    const char* e = tail.constData() + eocd;
+    declared_entries_ = read16(e + 10);
+    cd_size = read32(e + 12);
+    cd_offset = read32(e + 16);
+
+    // Zip64: a locator right before the EOCD points to the 64-bit record
+    bool needs_zip64 = declared_entries_ == 0xFFFF || cd_size == 0xFFFFFFFF || cd_offset == 0xFFFFFFFF;
+    if (eocd >= 20 && read32(e - 20) == kZip64LocatorSignature) {
+        quint64 zip64_offset = read64(e - 20 + 8);
+        if (file.seek(static_cast<qint64>(zip64_offset))) {
+            QByteArray rec = file.read(56);
+            if (rec.size() == 56 && read32(rec.constData()) == kZip64EocdSignature) {
+                declared_entries_ = read64(rec.constData() + 32);
+                cd_size = read64(rec.constData() + 40);
+                cd_offset = read64(rec.constData() + 48);
+                needs_zip64 = false;
+            }
+        }
+    }
+    return !needs_zip64;
+}
+
+const ZipEntry* ZipDirectory::find(const QString& name) const {
+    for (const ZipEntry& entry : entries_) {
+        if (entry.name == name) return &entry;
+    }
+    return nullptr;
+}
+
+QByteArray ZipDirectory::read_entry(const ZipEntry& entry, qint64 max_size) const {
+    if (entry.is_directory) return QByteArray();
+    if (entry.uncompressed_size > static_cast<quint64>(max_size) ||
+        entry.compressed_size > static_cast<quint64>(max_size)) {
+        return QByteArray();
+    }
+
+    QFile file(path_);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(static_cast<qint64>(entry.local_header_offset))) {
+        return QByteArray();
+    }
+    QByteArray local = file.read(kLocalHeaderSize);
+    if (local.size() != kLocalHeaderSize || read32(local.constData()) != kLocalHeaderSignature) {
+        return QByteArray();
+    }
+    // Local name/extra lengths can differ from the central directory's
+    qint64 data_offset = static_cast<qint64>(entry.local_header_offset) + kLocalHeaderSize
+                         + read16(local.constData() + 26) + read16(local.constData() + 28);
+    if (!file.seek(data_offset)) return QByteArray();
+    QByteArray compressed = file.read(static_cast<qint64>(entry.compressed_size));
+    if (static_cast<quint64>(compressed.size()) != entry.compressed_size) return QByteArray();
+
+    if (entry.method == 0) return compressed;
+
+#ifdef FILETINDER_HAS_ZLIB
+    if (entry.method == 8) {
+        QByteArray out(static_cast<qsizetype>(entry.uncompressed_size), Qt::Uninitialized);
+        z_stream stream{};
+        stream.next_in = reinterpret_cast<Bytef*>(compressed.data());
+        stream.avail_in = static_cast<uInt>(compressed.size());
+        stream.next_out = reinterpret_cast<Bytef*>(out.data());
+        stream.avail_out = static_cast<uInt>(out.size());
+        // Negative window bits: raw deflate stream, no zlib header
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return QByteArray();
+        int rc = inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
+        if (rc != Z_STREAM_END) return QByteArray();
+        out.truncate(static_cast<qsizetype>(stream.total_out));
+        return out;
+    }
+#endif
+    return QByteArray();
+}
+
+bool ZipDirectory::inflate_supported() {
+#ifdef FILETINDER_HAS_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
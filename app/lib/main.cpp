@@ -29,6 +29,7 @@
 #include "FileTinderExecutor.hpp"
 #include "AppLogger.hpp"
 #include "DiagnosticTool.hpp"
+#include "DocumentThumbnailer.hpp"
 #include "ui_constants.hpp"
 
 class FileTinderLauncher : public QDialog {
@@ -727,6 +728,11 @@ private:
 };
 
 int main(int argc, char* argv[]) {
+    // Child process for document previews, see DocumentThumbnailer::render_isolated
+    if (argc > 1 && qstrcmp(argv[1], DocumentThumbnailer::kRenderHelperFlag) == 0) {
+        return DocumentThumbnailer::run_render_helper(argc, argv);
+    }
+    
     QApplication qt_app(argc, argv);
     
     qt_app.setApplicationName("File Tinder");